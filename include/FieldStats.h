@@ -0,0 +1,136 @@
+/**
+ * @file FieldStats.h
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Window statistics (minimum, maximum, mean and standard deviation) of a
+ *        payload field.
+ * @details Samples are accumulated as raw field values (see \ref encodeField()), so
+ *          each sample costs only a few integer operations. Variance is computed
+ *          from sums of the differences to the first sample of the window, which keeps
+ *          the sums small and avoids the cancellation of the plain sum of squares.
+ * @version alpha
+ * @since 17/10/2026
+ * @date 17/10/2026
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __FIELD_STATS_H__
+#define __FIELD_STATS_H__
+
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * @class FieldStats
+ * @brief Statistics of the raw values of a field in a transmission window.
+ */
+class FieldStats {
+    private:
+        uint8_t count = 0;
+        uint16_t first = 0;
+        uint16_t minimum = 0;
+        uint16_t maximum = 0;
+        int32_t sum = 0;            // Sum of the differences to the first sample
+        uint64_t sumSquares = 0;    // Sum of the squared differences to the first sample
+
+    public:
+        /**
+         * @fn FieldStats::add(uint16_t raw)
+         * @brief Add a sample (samples after the 255th are ignored, like the averages).
+         * @param[in] raw - raw field value.
+         */
+        void add(uint16_t raw) {
+            if (this->count == 0) {
+                this->first = raw;
+                this->minimum = raw;
+                this->maximum = raw;
+            } else if (this->count == 255) {
+                return;
+            }
+            int32_t diff = (int32_t)raw - this->first;
+            uint16_t absDiff = (diff < 0) ? -diff : diff;
+
+            this->count++;
+            this->sum += diff;
+            this->sumSquares += (uint32_t)absDiff * absDiff;
+            if (raw < this->minimum) {
+                this->minimum = raw;
+            }
+            if (raw > this->maximum) {
+                this->maximum = raw;
+            }
+        }
+
+        /**
+         * @fn FieldStats::reset()
+         * @brief Start a new window.
+         */
+        void reset() {
+            this->count = 0;
+            this->sum = 0;
+            this->sumSquares = 0;
+        }
+
+        /**
+         * @fn FieldStats::getCount()
+         * @brief Get the number of samples of the window.
+         */
+        uint8_t getCount() const {
+            return this->count;
+        }
+
+        /**
+         * @fn FieldStats::getMin()
+         * @brief Get the lowest raw value of the window (0 if there are no samples).
+         */
+        uint16_t getMin() const {
+            return (this->count != 0) ? this->minimum : 0;
+        }
+
+        /**
+         * @fn FieldStats::getMax()
+         * @brief Get the highest raw value of the window (0 if there are no samples).
+         */
+        uint16_t getMax() const {
+            return (this->count != 0) ? this->maximum : 0;
+        }
+
+        /**
+         * @fn FieldStats::getMean()
+         * @brief Get the mean of the window (in raw units, NaN if there are no samples).
+         */
+        float getMean() const {
+            return (this->count != 0) ? this->first + (float)this->sum / this->count : NAN;
+        }
+
+        /**
+         * @fn FieldStats::getVariance()
+         * @brief Get the population variance of the window (in squared raw units).
+         */
+        float getVariance() const {
+            if (this->count < 2) {
+                return 0.0f;
+            }
+            float mean = (float)this->sum / this->count;
+            float variance = (float)this->sumSquares / this->count - mean * mean;
+
+            return (variance > 0.0f) ? variance : 0.0f;
+        }
+
+        /**
+         * @fn FieldStats::getStdDev()
+         * @brief Get the population standard deviation of the window (rounded, in raw units).
+         */
+        uint16_t getStdDev() const {
+            float stdDev = sqrt(getVariance()) + 0.5f;
+
+            return (stdDev < 65535.0f) ? (uint16_t)stdDev : 65535;
+        }
+};
+
+#endif // __FIELD_STATS_H__
@@ -0,0 +1,134 @@
+/**
+ * @file FixedPoint.h
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Rounding and saturating conversion of values to fixed point fields.
+ * @details Platform neutral (only standard C headers), so the network server side
+ *          decoder builds the same file with any C++11 compiler.\n
+ *          raw = round(value * Scale / Divisor), limited to the range of a \p Bits wide
+ *          field. Integer values are converted with integer only arithmetic.
+ * @version alpha
+ * @since 17/10/2026
+ * @date 17/10/2026
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __FIXED_POINT_H__
+#define __FIXED_POINT_H__
+
+#include <stdint.h>
+
+/**
+ * @struct fixed_range
+ * @brief Range of a fixed point field.
+ * @tparam Bits - field width (1 to 16 bits).
+ * @tparam Signed - two's complement field.
+ */
+template <uint8_t Bits, bool Signed>
+struct fixed_range {
+    static_assert((Bits >= 1) && (Bits <= 16), "fixed point fields are 1 to 16 bits wide");
+
+    static constexpr int32_t min = Signed ? -(1L << (Bits - 1)) : 0;                        /**< Lowest value. */
+    static constexpr int32_t max = Signed ? (1L << (Bits - 1)) - 1 : (1L << Bits) - 1;      /**< Highest value. */
+    static constexpr uint16_t mask = (uint16_t)((1UL << Bits) - 1);                        /**< Field bits. */
+};
+
+/**
+ * @struct fixed_converter
+ * @brief Conversion of integer (\p Integer = true) or floating point values (see \ref to_fixed()).
+ */
+template <uint8_t Bits, uint16_t Scale, bool Signed, uint16_t Divisor, bool Integer>
+struct fixed_converter;
+
+template <uint8_t Bits, uint16_t Scale, bool Signed, uint16_t Divisor>
+struct fixed_converter<Bits, Scale, Signed, Divisor, true> {
+    static int32_t convert(int32_t value) {
+        typedef fixed_range<Bits, Signed> range;
+
+        // Limit before scaling, so the product never overflows
+        if (value > (int32_t)(0x7FFFFFFFL / Scale) - Divisor) {
+            return range::max;
+        }
+        if (value < -(int32_t)(0x7FFFFFFFL / Scale) + Divisor) {
+            return range::min;
+        }
+        int32_t scaled = value * Scale;
+        if (Divisor != 1) {
+            // Round half away from zero
+            scaled = (scaled >= 0) ? (scaled + Divisor / 2) / Divisor : -((-scaled + Divisor / 2) / Divisor);
+        }
+        if (scaled > range::max) {
+            return range::max;
+        }
+        if (scaled < range::min) {
+            return range::min;
+        }
+        return scaled;
+    }
+};
+
+template <uint8_t Bits, uint16_t Scale, bool Signed, uint16_t Divisor>
+struct fixed_converter<Bits, Scale, Signed, Divisor, false> {
+    static int32_t convert(float value) {
+        typedef fixed_range<Bits, Signed> range;
+
+        if (value != value) {
+            return 0;   // NaN
+        }
+        // Round half away from zero
+        float scaled = value * Scale / Divisor;
+        scaled += (scaled >= 0.0f) ? 0.5f : -0.5f;
+        if (scaled >= (float)range::max) {
+            return range::max;
+        }
+        if (scaled <= (float)range::min) {
+            return range::min;
+        }
+        return (int32_t)scaled;
+    }
+};
+
+/**
+ * @fn to_fixed
+ * @brief Convert a value to a fixed point field: round(value * Scale / Divisor), limited
+ *        to the field range (NaN is converted to 0).
+ * @tparam Bits - field width (1 to 16 bits).
+ * @tparam Scale - field units per value unit.
+ * @tparam Signed - two's complement field (otherwise negative values are limited to 0).
+ * @tparam Divisor - value units per field unit, for fields coarser than the value.
+ * @param[in] value - integer or floating point value.
+ * @return uint16_t - field bits (upper bits are 0, see \ref from_fixed()).
+ */
+template <uint8_t Bits, uint16_t Scale, bool Signed = false, uint16_t Divisor = 1, class T>
+inline uint16_t to_fixed(T value) {
+    static_assert((Scale != 0) && (Divisor != 0), "fixed point scale and divisor must not be 0");
+
+    // (T)0.5 is 0 only for integer types
+    typedef fixed_converter<Bits, Scale, Signed, Divisor, ((T)0.5 == 0)> converter;
+
+    return (uint16_t)converter::convert(value) & fixed_range<Bits, Signed>::mask;
+}
+
+/**
+ * @fn from_fixed
+ * @brief Get the integer value of a fixed point field (sign extended when \p Signed).
+ * @tparam Bits - field width (1 to 16 bits).
+ * @tparam Signed - two's complement field.
+ * @param[in] raw - field bits.
+ * @return int32_t - field value (divide by Scale / Divisor to get the original value).
+ */
+template <uint8_t Bits, bool Signed = false>
+inline int32_t from_fixed(uint16_t raw) {
+    raw &= fixed_range<Bits, Signed>::mask;
+    if (Signed && (raw & (1U << (Bits - 1)))) {
+        return (int32_t)raw - (1L << Bits);
+    }
+    return raw;
+}
+
+#endif // __FIXED_POINT_H__
@@ -0,0 +1,375 @@
+/**
+ * @file Fragment.h
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Fragmentation of large blocks in LoRaWAN frames (station) and their
+ *        reassembly (station or host).
+ * @details Platform neutral (only standard C headers), so the network server side
+ *          decoder builds the same file with any C++11 compiler.\n
+ *          Fragment layout:\n
+ *          1 byte  - batch id (sequence number of the block)\n
+ *          1 byte  - fragment index\n
+ *          1 byte  - number of fragments of the block (up to \ref FRAGMENT_MAX_COUNT)\n
+ *          N bytes - fragment data\n
+ *          Optional parity fragment (sent after the last one), which rebuilds one lost
+ *          fragment of the block:\n
+ *          1 byte  - batch id\n
+ *          1 byte  - \ref FRAGMENT_PARITY_FLAG | number of fragments of the block\n
+ *          1 byte  - data size of the last fragment\n
+ *          N bytes - XOR of the data of all fragments (zero padded to the largest one)
+ * @version alpha
+ * @since 17/10/2026
+ * @date 17/10/2026
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __FRAGMENT_H__
+#define __FRAGMENT_H__
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * \def FRAGMENT_HEADER_SIZE
+ * Size (in bytes) of the fragment header.
+ */
+#define FRAGMENT_HEADER_SIZE        3
+
+/**
+ * \def FRAGMENT_MAX_COUNT
+ * Maximum number of fragments of a block.
+ */
+#define FRAGMENT_MAX_COUNT          127
+
+/**
+ * \def FRAGMENT_PARITY_FLAG
+ * Index byte flag of the parity fragment.
+ */
+#define FRAGMENT_PARITY_FLAG        0x80
+
+/**
+ * @class Fragmenter
+ * @brief Split a block in sequenced fragments sized for the current maximum payload.
+ * @details Block is not copied, so it must not change until the last fragment is sent.
+ *          With parity, one more fragment is sent, so the block survives the loss of
+ *          any one of its fragments. Losing more fragments drops the block. A block
+ *          sent in a single fragment gets no parity fragment (it would only repeat it).
+ */
+class Fragmenter {
+    private:
+        const uint8_t* block = NULL;
+        uint16_t size = 0;
+        uint8_t dataSize = 0;
+        uint8_t batch = 0;
+        uint8_t index = 0;
+        uint8_t count = 0;
+        bool parity = false;
+
+        /**
+         * @fn Fragmenter::getParity(uint8_t* frame)
+         * @brief Write the parity fragment (XOR of the data of all fragments).
+         */
+        uint8_t getParity(uint8_t* frame) const {
+            frame[0] = this->batch;
+            frame[1] = FRAGMENT_PARITY_FLAG | this->count;
+            frame[2] = (uint8_t)(this->size - (uint16_t)(this->count - 1) * this->dataSize);
+            memset(frame + FRAGMENT_HEADER_SIZE, 0, this->dataSize);
+            for (uint16_t i = 0; i < this->size; i++) {
+                frame[FRAGMENT_HEADER_SIZE + (i % this->dataSize)] ^= this->block[i];
+            }
+
+            return FRAGMENT_HEADER_SIZE + this->dataSize;
+        }
+
+    public:
+        /**
+         * @fn Fragmenter::begin(const uint8_t* block, uint16_t size, uint8_t maxPayload, bool parity)
+         * @brief Start a new batch (a pending one is abandoned).
+         * @param[in] block - block to be sent.
+         * @param[in] size - block size (in bytes).
+         * @param[in] maxPayload - maximum frame payload (in bytes) at the current datarate.
+         * @param[in] parity - send a parity fragment after the last one (only blocks
+         *            of more than one fragment).
+         * @retval true - batch started.
+         * @retval false - empty block, payload too small or more than
+         *         \ref FRAGMENT_MAX_COUNT fragments.
+         */
+        bool begin(const uint8_t* block, uint16_t size, uint8_t maxPayload, bool parity = false) {
+            this->count = 0;
+            this->index = 0;
+            if ((size == 0) || (maxPayload <= FRAGMENT_HEADER_SIZE)) {
+                return false;
+            }
+            uint16_t count = (size + (maxPayload - FRAGMENT_HEADER_SIZE) - 1) / (maxPayload - FRAGMENT_HEADER_SIZE);
+            if (count > FRAGMENT_MAX_COUNT) {
+                return false;
+            }
+
+            this->block = block;
+            this->size = size;
+            this->dataSize = maxPayload - FRAGMENT_HEADER_SIZE;
+            this->count = (uint8_t)count;
+            this->parity = parity && (count > 1);
+            this->batch++;
+
+            return true;
+        }
+
+        /**
+         * @fn Fragmenter::pending()
+         * @brief Check if there are fragments to be sent.
+         */
+        bool pending() const {
+            return (this->index < this->count) || ((this->index == this->count) && this->parity && (this->count != 0));
+        }
+
+        /**
+         * @fn Fragmenter::get(uint8_t* frame)
+         * @brief Write the current fragment (header and data).
+         * @param[out] frame - frame buffer (at least maxPayload bytes).
+         * @return uint8_t - frame size (in bytes), 0 if there is no fragment pending.
+         */
+        uint8_t get(uint8_t* frame) const {
+            if (!pending()) {
+                return 0;
+            }
+            if (this->index == this->count) {
+                return getParity(frame);
+            }
+            uint16_t offset = (uint16_t)this->index * this->dataSize;
+            uint8_t size = ((this->size - offset) < this->dataSize) ? (uint8_t)(this->size - offset) : this->dataSize;
+
+            frame[0] = this->batch;
+            frame[1] = this->index;
+            frame[2] = this->count;
+            memcpy(frame + FRAGMENT_HEADER_SIZE, this->block + offset, size);
+
+            return FRAGMENT_HEADER_SIZE + size;
+        }
+
+        /**
+         * @fn Fragmenter::next()
+         * @brief Move to the next fragment (once the current one was sent).
+         */
+        void next() {
+            if (pending()) {
+                this->index++;
+            }
+        }
+
+        /**
+         * @fn Fragmenter::getBatch()
+         * @brief Get the id of the current batch (changed by every \ref begin()).
+         */
+        uint8_t getBatch() const {
+            return this->batch;
+        }
+
+        /**
+         * @fn Fragmenter::cancel()
+         * @brief Abandon the batch (its fragments not sent yet are dropped).
+         */
+        void cancel() {
+            this->count = 0;
+            this->index = 0;
+        }
+};
+
+/**
+ * @class FragmentReassembler
+ * @brief Rebuild blocks from fragments received in any order.
+ * @details Up to \p MaxBatches blocks are rebuilt at the same time. One lost fragment
+ *          is rebuilt from the parity fragment, if the block has one. Blocks still missing
+ *          fragments are dropped when a batch \p MaxBatches ids newer arrives (or when
+ *          their slot is needed), so lost fragments never stall the decoder. Repeated
+ *          fragments, and fragments (or parity) arriving after their block was rebuilt,
+ *          are ignored, so each block is delivered once.
+ * @tparam MaxFragments - maximum number of fragments of a block.
+ * @tparam MaxFragmentSize - maximum fragment data size (in bytes).
+ * @tparam MaxBatches - number of blocks rebuilt at the same time.
+ */
+template <uint8_t MaxFragments, uint8_t MaxFragmentSize, uint8_t MaxBatches>
+class FragmentReassembler {
+    static_assert(MaxFragments <= FRAGMENT_MAX_COUNT, "blocks have up to FRAGMENT_MAX_COUNT fragments");
+
+    private:
+        struct Batch {
+            bool used;
+            bool complete;              // Block delivered, slot kept to ignore late fragments
+            uint8_t id;
+            uint8_t count;
+            uint8_t received;
+            uint8_t sizes[MaxFragments];
+            uint8_t data[MaxFragments][MaxFragmentSize];
+            uint8_t paritySize;         // 0 until the parity fragment arrives
+            uint8_t lastSize;
+            uint8_t parity[MaxFragmentSize];
+        };
+        Batch batches[MaxBatches];
+        uint8_t newest = 0;
+        bool started = false;
+
+        Batch* getBatch(uint8_t id, uint8_t count) {
+            Batch* oldest = NULL;
+
+            // Forget blocks too old to be completed
+            if (!this->started || ((uint8_t)(id - this->newest) < 128)) {
+                this->newest = id;
+                this->started = true;
+            }
+            for (uint8_t i = 0; i < MaxBatches; i++) {
+                if (this->batches[i].used && ((uint8_t)(this->newest - this->batches[i].id) >= MaxBatches)) {
+                    this->batches[i].used = false;
+                }
+            }
+            if ((uint8_t)(this->newest - id) >= MaxBatches) {
+                return NULL;
+            }
+
+            for (uint8_t i = 0; i < MaxBatches; i++) {
+                if (this->batches[i].used && (this->batches[i].id == id)) {
+                    return (this->batches[i].count == count) ? &this->batches[i] : NULL;
+                }
+            }
+
+            // New block takes a free slot, or the slot of the oldest block
+            for (uint8_t i = 0; i < MaxBatches; i++) {
+                if (!this->batches[i].used) {
+                    oldest = &this->batches[i];
+                    break;
+                }
+                if ((oldest == NULL) || ((uint8_t)(this->newest - this->batches[i].id) > (uint8_t)(this->newest - oldest->id))) {
+                    oldest = &this->batches[i];
+                }
+            }
+
+            oldest->used = true;
+            oldest->complete = false;
+            oldest->id = id;
+            oldest->count = count;
+            oldest->received = 0;
+            oldest->paritySize = 0;
+            memset(oldest->sizes, 0, sizeof(oldest->sizes));
+
+            return oldest;
+        }
+
+        /**
+         * @fn FragmentReassembler::recover(Batch* batch)
+         * @brief Rebuild the only missing fragment of a block from its parity fragment.
+         */
+        void recover(Batch* batch) {
+            uint8_t missing = 0;
+            while (batch->sizes[missing] != 0) {
+                missing++;
+            }
+
+            uint8_t size = (missing == (batch->count - 1)) ? batch->lastSize : batch->paritySize;
+            memcpy(batch->data[missing], batch->parity, size);
+            for (uint8_t i = 0; i < batch->count; i++) {
+                for (uint8_t j = 0; (i != missing) && (j < batch->sizes[i]) && (j < size); j++) {
+                    batch->data[missing][j] ^= batch->data[i][j];
+                }
+            }
+            batch->sizes[missing] = size;
+            batch->received++;
+        }
+
+        /**
+         * @fn FragmentReassembler::addParity(const uint8_t* frame, uint8_t size)
+         * @brief Keep the parity fragment of a block.
+         * @return Batch* - block of the fragment, NULL if the fragment is invalid.
+         */
+        Batch* addParity(const uint8_t* frame, uint8_t size) {
+            uint8_t count = frame[1] & ~FRAGMENT_PARITY_FLAG;
+            if ((count == 0) || (count > MaxFragments) || (frame[2] == 0) ||
+                (frame[2] > (size - FRAGMENT_HEADER_SIZE))) {
+                return NULL;
+            }
+
+            Batch* batch = getBatch(frame[0], count);
+            if ((batch != NULL) && !batch->complete && (batch->paritySize == 0)) {
+                batch->paritySize = size - FRAGMENT_HEADER_SIZE;
+                batch->lastSize = frame[2];
+                memcpy(batch->parity, frame + FRAGMENT_HEADER_SIZE, batch->paritySize);
+            }
+
+            return batch;
+        }
+
+    public:
+        FragmentReassembler() {
+            memset(this->batches, 0, sizeof(this->batches));
+        }
+
+        /**
+         * @fn FragmentReassembler::add(const uint8_t* frame, uint8_t size, uint8_t* block, uint16_t blockSize)
+         * @brief Add a received fragment (data or parity).
+         * @param[in] frame - fragment (header and data).
+         * @param[in] size - fragment size (in bytes).
+         * @param[out] block - rebuilt block, written when its last missing fragment arrives.
+         * @param[in] blockSize - size of \p block buffer (in bytes).
+         * @return int32_t - size of the rebuilt block, 0 if the block is still incomplete
+         *         or -1 if the fragment is invalid (or \p block is too small).
+         */
+        int32_t add(const uint8_t* frame, uint8_t size, uint8_t* block, uint16_t blockSize) {
+            Batch* batch = NULL;
+
+            if ((size <= FRAGMENT_HEADER_SIZE) || ((size - FRAGMENT_HEADER_SIZE) > MaxFragmentSize)) {
+                return -1;
+            }
+            if ((frame[1] & FRAGMENT_PARITY_FLAG) != 0) {
+                batch = addParity(frame, size);
+                if (batch == NULL) {
+                    return -1;
+                }
+            } else {
+                if ((frame[2] == 0) || (frame[2] > MaxFragments) || (frame[1] >= frame[2])) {
+                    return -1;
+                }
+                batch = getBatch(frame[0], frame[2]);
+                if (batch == NULL) {
+                    return -1;
+                }
+                if (batch->complete || (batch->sizes[frame[1]] != 0)) {
+                    return 0;
+                }
+                batch->sizes[frame[1]] = size - FRAGMENT_HEADER_SIZE;
+                memcpy(batch->data[frame[1]], frame + FRAGMENT_HEADER_SIZE, size - FRAGMENT_HEADER_SIZE);
+                batch->received++;
+            }
+
+            if (batch->complete) {
+                return 0;
+            }
+
+            // Parity rebuilds the only missing fragment
+            if ((batch->paritySize != 0) && ((batch->received + 1) == batch->count)) {
+                recover(batch);
+            }
+            if (batch->received < batch->count) {
+                return 0;
+            }
+
+            // Block complete, so join the fragments in order (slot is freed when the
+            // block gets too old, so its late fragments are still recognized)
+            uint32_t total = 0;
+            batch->complete = true;
+            for (uint8_t i = 0; i < batch->count; i++) {
+                if ((total + batch->sizes[i]) > blockSize) {
+                    return -1;
+                }
+                memcpy(block + total, batch->data[i], batch->sizes[i]);
+                total += batch->sizes[i];
+            }
+
+            return (int32_t)total;
+        }
+};
+
+#endif // __FRAGMENT_H__
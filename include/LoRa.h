@@ -18,6 +18,8 @@
 #define __LORA_H__
 
 #include <Arduino.h>
+#include <EEPROM.h>
+#include "convert_tools.h"
 
 /**
  * @enum LoRaBaseBand_e
@@ -180,14 +182,149 @@ enum LoRaAuthMode_e {
 enum LoRaStatusCode_e {
     LORA_STATUS_OK,
     LORA_STATUS_UART_FAIL,
-    LORA_STATUS_UNINITIALIZED    
+    LORA_STATUS_UNINITIALIZED,
+    LORA_STATUS_TIMEOUT,
+    LORA_STATUS_AT_ERROR,
+    LORA_STATUS_BUSY,
+    LORA_STATUS_NO_BAND,
+    LORA_STATUS_NOT_JOINED,
+    LORA_STATUS_NO_ACK,
+    LORA_STATUS_INVALID_PARAM,
+    LORA_STATUS_NO_AIRTIME
 };
 
+/**
+ * @enum LoRaTxStatus_e
+ * @brief Status of the last transmission.
+ * @var LORA_TX_IDLE
+ * No message was sent yet.
+ * @var LORA_TX_PENDING
+ * Message is being transmitted (TX and RX windows).
+ * @var LORA_TX_DONE
+ * Message was transmitted.
+ * @var LORA_TX_FAILED
+ * Transmission failed (see \ref LoRaRadio::getLastError()).
+ */
+enum LoRaTxStatus_e {
+    LORA_TX_IDLE,
+    LORA_TX_PENDING,
+    LORA_TX_DONE,
+    LORA_TX_FAILED
+};
+
+/**
+ * @enum LoRaJoinStatus_e
+ * @brief Network join status.
+ * @var LORA_NOT_JOINED
+ * OTAA device waiting for the next join attempt.
+ * @var LORA_JOINING
+ * OTAA join in progress.
+ * @var LORA_JOINED
+ * Device may send messages (ABP device or OTAA session established).
+ */
+enum LoRaJoinStatus_e {
+    LORA_NOT_JOINED,
+    LORA_JOINING,
+    LORA_JOINED
+};
+
+/**
+ * @typedef LoRaTxCallback_t
+ * @brief Function called when a transmission ends (status and error code).
+ */
+typedef void (*LoRaTxCallback_t)(LoRaTxStatus_e txStatus, uint8_t statusCode);
+
+/**
+ * @typedef LoRaRxHandler_t
+ * @brief Function called when a downlink is received on its port (port, payload and size).
+ */
+typedef void (*LoRaRxHandler_t)(uint8_t port, const uint8_t* buf, uint8_t size);
+
+/**
+ * \def LORA_MAX_RX_HANDLERS
+ * Maximum number of downlink port handlers.
+ */
+#ifndef LORA_MAX_RX_HANDLERS
+    #define LORA_MAX_RX_HANDLERS    4
+#endif
+
+/**
+ * @struct LoRaRxHandlerEntry_t
+ * @brief Downlink handler registered for a port.
+ */
+struct LoRaRxHandlerEntry_t {
+    uint8_t port;               /**< LoRa port. */
+    LoRaRxHandler_t handler;    /**< Handler function. */
+};
+
+/**
+ * @enum LoRaATState_e
+ * @brief State of the AT transaction in progress.
+ * @var LORA_AT_IDLE
+ * No AT command was sent yet.
+ * @var LORA_AT_WAITING
+ * AT command sent, waiting for the modem response.
+ * @var LORA_AT_DONE
+ * Modem response received.
+ * @var LORA_AT_ERROR
+ * Modem answered with an error.
+ * @var LORA_AT_TIMEOUT
+ * Modem did not answer before the command deadline.
+ */
+enum LoRaATState_e {
+    LORA_AT_IDLE,
+    LORA_AT_WAITING,
+    LORA_AT_DONE,
+    LORA_AT_ERROR,
+    LORA_AT_TIMEOUT
+};
+
+/**
+ * \def LORA_MAX_PAYLOAD_SIZE
+ * Maximum size (in bytes) of an application payload handled by the driver.
+ */
+#ifndef LORA_MAX_PAYLOAD_SIZE
+    #define LORA_MAX_PAYLOAD_SIZE   64
+#endif
+
+/**
+ * \def LORA_RX_BUFFER_SIZE
+ * Size of the buffer used to assemble each response line of the modem.
+ */
+#ifndef LORA_RX_BUFFER_SIZE
+    #define LORA_RX_BUFFER_SIZE     96
+#endif
+
+/**
+ * \def LORA_AT_PREFIX_SIZE
+ * Size of the expected response prefix (e.g. "+MSGHEX:").
+ */
+#define LORA_AT_PREFIX_SIZE         12
+
+/**
+ * \def LORA_UART_DEFAULT_BAUDRATE
+ * Factory baud rate of the modem UART.
+ */
+#define LORA_UART_DEFAULT_BAUDRATE  9600
+
+/**
+ * \def LORA_CMD_TIMEOUT
+ * Default deadline (in ms) of a configuration AT command.
+ */
+#define LORA_CMD_TIMEOUT            300
+
+/**
+ * \def LORA_TX_TIMEOUT
+ * Deadline (in ms) of a transmission AT command (TX plus both RX windows).
+ */
+#define LORA_TX_TIMEOUT             10000
+
 /**
  * @struct LoRaConfig_t
  * @brief LoRa configuration struct.
  */
 struct LoRaConfig_t {
+    uint32_t uart_baudrate;     /**< MCU-modem UART baud rate (0 = \ref LORA_UART_DEFAULT_BAUDRATE). */
     LoRaBaseBand_e baseband;    /**< LoRa base band. */
     uint8_t subband;            /**< LoRa sub band. */
     LoRaClass_e op_class;       /**< LoRa class. */
@@ -198,7 +335,11 @@ struct LoRaConfig_t {
     String dev_eui;             /**< LoRa DevEUI. */
     String app_eui;             /**< LoRa AppEUI. */
     String repeat;              /**< LoRa unconfirmed message repeat time. */
-    String retry;               /**< LoRa confirmed message retry times. */
+    uint8_t retry;              /**< LoRa confirmed message retry times. */
+    uint16_t retry_backoff;     /**< Delay (in ms) before the first retry, doubled at each retry. */
+    uint8_t confirm_every;      /**< Confirm one of every N messages sent by sendMsgHex() (0 = never). */
+    uint8_t link_check_every;   /**< Request a link check with one of every N messages (0 = never). */
+    uint32_t time_sync_period;  /**< Clock synchronization period (in ms, 0 = never, may be set by the network), see \ref LoRaRadio::requestTimeSync(). */
     String dev_addr;            /**< LoRa device address. */
     String app_key;             /**< LoRa application key. */
     String apps_key;            /**< LoRa application session key. */
@@ -209,387 +350,1091 @@ struct LoRaConfig_t {
     LoRaDR_e chan0_dr;          /**< LoRa channel 0 datarate. */
     String chan1_freq;          /**< LoRa channel 1 frequency. */
     LoRaDR_e chan1_dr;          /**< LoRa channel 1 datarate. */
-    bool debug;                 /**< Enable/disable LoRa debug. */
-    HardwareSerial* serialDebug; /**< Serial used to debug. */
-    HardwareSerial* serialLora;  /**< Serial used to LoRaWAN modem. */
+    uint32_t airtime_budget;    /**< Uplink time on air (in ms) allowed per airtime window (0 = unlimited). */
+    uint32_t airtime_window;    /**< Airtime window (in ms). */
+    uint8_t downlink_budget;    /**< Downlinks requested (confirmed messages, link checks and clock synchronizations) allowed per airtime window (0 = unlimited), see \ref LoRaRadio::isDownlinkAvailable(). */
+    bool low_power;             /**< Put the modem in low power mode between messages (class A only). */
+    uint16_t eeprom_addr;       /**< EEPROM address of LoRa persistent data. */
+};
+
+/**
+ * \def LORA_CONFIG_VERSION
+ * Version of the configuration pushed by the driver (part of its fingerprint, 
+ * so a new version forces the modem to be configured again).
+ */
+#define LORA_CONFIG_VERSION         1
+
+/**
+ * \def LORA_EEPROM_MAGIC
+ * Marker of a valid LoRa configuration record in EEPROM.
+ */
+#define LORA_EEPROM_MAGIC           0x4C52
+
+/**
+ * \def LORA_PHY_OVERHEAD
+ * LoRaWAN bytes added to the application payload (MHDR, FHDR without FOpts, FPort and MIC).
+ */
+#define LORA_PHY_OVERHEAD           13
+
+/**
+ * \def LORA_CLOCK_SYNC_PORT
+ * LoRa port of the application layer clock synchronization (LoRaWAN TS003).
+ */
+#define LORA_CLOCK_SYNC_PORT        202
+
+/**
+ * \def LORA_TIME_SYNC_SIZE
+ * Size (in bytes) of a clock synchronization request (AppTimeReq).
+ */
+#define LORA_TIME_SYNC_SIZE         6
+
+/**
+ * \def LORA_TIME_SYNC_MAX_SIZE
+ * Maximum size (in bytes) of a clock synchronization uplink (PackageVersionAns, 
+ * DeviceAppTimePeriodicityAns and AppTimeReq).
+ */
+#define LORA_TIME_SYNC_MAX_SIZE     (3 + 6 + LORA_TIME_SYNC_SIZE)
+
+/**
+ * \def LORA_TIME_PERIOD_UNIT
+ * Unit (in ms) of the DeviceAppTimePeriodicityReq period (128 s * 2^Periodicity).
+ */
+#define LORA_TIME_PERIOD_UNIT       128000UL
+
+/**
+ * \def LORA_TIME_SYNC_RETRY
+ * Delay (in ms) before a clock synchronization request not answered is sent again.
+ */
+#define LORA_TIME_SYNC_RETRY        600000UL
+
+/**
+ * \def LORA_WAKE_PREAMBLE_SIZE
+ * Number of 0xFF bytes sent to wake the modem up from low power mode.
+ */
+#define LORA_WAKE_PREAMBLE_SIZE     4
+
+/**
+ * \def LORA_WAKE_DELAY
+ * Delay (in ms) between the wake up preamble and the first command.
+ */
+#define LORA_WAKE_DELAY             10
+
+/**
+ * \def LORA_WAKE_RETRY
+ * Number of AT probes sent until the modem answers after waking up.
+ */
+#define LORA_WAKE_RETRY             3
+
+/**
+ * \def LORA_JOIN_TIMEOUT
+ * Deadline (in ms) of an OTAA join attempt.
+ */
+#define LORA_JOIN_TIMEOUT           20000
+
+/**
+ * \def LORA_JOIN_BACKOFF
+ * Delay (in ms) before the first OTAA join retry, doubled at each failed attempt.
+ */
+#define LORA_JOIN_BACKOFF           15000UL
+
+/**
+ * \def LORA_JOIN_BACKOFF_MAX
+ * Maximum delay (in ms) between OTAA join attempts.
+ */
+#define LORA_JOIN_BACKOFF_MAX       3600000UL
+
+/**
+ * \def LORA_FCNT_SLOTS
+ * Number of EEPROM slots used (round robin) to save frame counters.
+ */
+#define LORA_FCNT_SLOTS             8
+
+/**
+ * \def LORA_FCNT_SAVE_INTERVAL
+ * Frame counters are saved every N messages (and restored N ahead).
+ */
+#define LORA_FCNT_SAVE_INTERVAL     16
+
+/**
+ * \def LORA_EEPROM_CONFIG_OFFSET
+ * Offset (from \ref LoRaConfig_t::eeprom_addr) of the configuration fingerprint.
+ */
+#define LORA_EEPROM_CONFIG_OFFSET   0
+
+/**
+ * \def LORA_EEPROM_SESSION_OFFSET
+ * Offset (from \ref LoRaConfig_t::eeprom_addr) of the OTAA session record.
+ */
+#define LORA_EEPROM_SESSION_OFFSET  4
+
+/**
+ * \def LORA_EEPROM_FCNT_OFFSET
+ * Offset (from \ref LoRaConfig_t::eeprom_addr) of the frame counters slots.
+ */
+#define LORA_EEPROM_FCNT_OFFSET     20
+
+/**
+ * \def LORA_EEPROM_SIZE
+ * EEPROM size (in bytes) reserved by the LoRa driver.
+ */
+#define LORA_EEPROM_SIZE            128
+
+/**
+ * \def LORA_LINK_STATS_SIZE
+ * Number of transmissions kept in the link statistics ring.
+ */
+#define LORA_LINK_STATS_SIZE        8
+
+/**
+ * \def LORA_LINK_HEALTH_SIZE
+ * Size (in bytes) of the link health block (see \ref LoRaRadio::getLinkHealth()).
+ */
+#define LORA_LINK_HEALTH_SIZE       5
+
+/**
+ * \def LORA_LINK_RSSI
+ * \ref LoRaLinkStats_t flag: downlink RSSI and SNR are valid.
+ */
+#define LORA_LINK_RSSI              0x01
+
+/**
+ * \def LORA_LINK_CHECK
+ * \ref LoRaLinkStats_t flag: link margin and gateway count are valid.
+ */
+#define LORA_LINK_CHECK             0x02
+
+/**
+ * @struct LoRaLinkStats_t
+ * @brief Link statistics of a transmission.
+ */
+struct LoRaLinkStats_t {
+    uint8_t status;             /**< Transmission status code (see \ref LoRaStatusCode_e). */
+    uint8_t flags;              /**< Valid fields (\ref LORA_LINK_RSSI, \ref LORA_LINK_CHECK). */
+    int16_t rssi;               /**< Downlink RSSI (in dBm). */
+    int8_t snr;                 /**< Downlink SNR (in dB). */
+    uint8_t margin;             /**< Link margin reported by the network (in dB). */
+    uint8_t gateways;           /**< Number of gateways that received the uplink. */
+};
+
+/**
+ * @struct LoRaConfigRecord_t
+ * @brief Fingerprint of the configuration pushed to the modem (stored in EEPROM).
+ */
+struct LoRaConfigRecord_t {
+    uint16_t magic;             /**< Record marker (see \ref LORA_EEPROM_MAGIC). */
+    uint16_t crc;               /**< CRC-16 of the modem related configuration. */
+};
+
+/**
+ * @struct LoRaSessionRecord_t
+ * @brief OTAA session established by the last join (stored in EEPROM).
+ */
+struct LoRaSessionRecord_t {
+    uint16_t magic;             /**< Record marker (see \ref LORA_EEPROM_MAGIC). */
+    uint16_t crc;               /**< Configuration fingerprint used to join. */
+    char dev_addr[9];           /**< DevAddr assigned by the network. */
+};
+
+/**
+ * @struct LoRaFCntRecord_t
+ * @brief Frame counters slot (stored in EEPROM).
+ */
+struct LoRaFCntRecord_t {
+    uint16_t seq;               /**< Write sequence (newest slot has the highest one). */
+    uint32_t uplink;            /**< Uplink frame counter. */
+    uint32_t downlink;          /**< Downlink frame counter. */
+    uint16_t crc;               /**< CRC-16 of the previous fields. */
+};
+
+/**
+ * @struct LoRaNoLog
+ * @brief Logging policy of release builds: debug messages are compiled out.
+ */
+struct LoRaNoLog {
+    static const bool enabled = false;
+    template <class T> static void print(T) {}
+    static void flush() {}
+};
+
+/**
+ * @struct LoRaSerialLog
+ * @brief Logging policy that prints debug messages to the stream set by \ref begin().
+ */
+struct LoRaSerialLog {
+    static const bool enabled = true;
+
+    static Print*& stream() {
+        static Print* out = NULL;
+        return out;
+    }
+
+    static void begin(Print& out) {
+        stream() = &out;
+    }
+
+    template <class T> static void print(T value) {
+        if (stream() != NULL) {
+            stream()->print(value);
+        }
+    }
+
+    static void flush() {
+        if (stream() != NULL) {
+            stream()->flush();
+        }
+    }
 };
 
-class LoRa {
-    private:
+constexpr uint8_t LORA_EU_PAYLOAD_SIZES[] = {51, 51, 51, 115, 222, 222, 222, 222};  /**< EU868 payload sizes (DR0 to DR7). */
+constexpr uint8_t LORA_US_PAYLOAD_SIZES[] = {11, 53, 125, 242, 242};                /**< US915 and AU920 payload sizes (DR0 to DR4). */
+
+/**
+ * @fn getLoRaPayloadSize
+ * @brief Get the maximum application payload of a datarate (no MAC commands piggybacked), 
+ *        datarates not used for uplinks as DR0.
+ */
+constexpr uint8_t getLoRaPayloadSize(LoRaBaseBand_e baseband, LoRaDR_e dr) {
+    return (baseband == EU868) ? 
+           ((dr < sizeof(LORA_EU_PAYLOAD_SIZES)) ? LORA_EU_PAYLOAD_SIZES[dr] : LORA_EU_PAYLOAD_SIZES[0]) :
+           ((dr < sizeof(LORA_US_PAYLOAD_SIZES)) ? LORA_US_PAYLOAD_SIZES[dr] : LORA_US_PAYLOAD_SIZES[0]);
+}
+
+/**
+ * @fn getLoRaMaxPayloadSize
+ * @brief Get the maximum application payload of a datarate, limited to 
+ *        \ref LORA_MAX_PAYLOAD_SIZE (usable at compile time, e.g. to check frame sizes).
+ * @param[in] baseband - base band (see \ref LoRaBaseBand_e).
+ * @param[in] dr - uplink datarate (see \ref LoRaDR_e).
+ * @return uint8_t - maximum payload size (in bytes).
+ */
+constexpr uint8_t getLoRaMaxPayloadSize(LoRaBaseBand_e baseband, LoRaDR_e dr) {
+    return (getLoRaPayloadSize(baseband, dr) < LORA_MAX_PAYLOAD_SIZE) ? getLoRaPayloadSize(baseband, dr) : LORA_MAX_PAYLOAD_SIZE;
+}
+
+/**
+ * @class LoRaRadio
+ * @brief Radio independent part of the LoRaWAN drivers: downlink handlers, airtime 
+ *        budget, link statistics and confirmation policy.
+ * @details Backends derive from it passing themselves as \p Derived (CRTP), so calls 
+ *          between both sides are statically dispatched. Backends implement init(), 
+ *          poll(), isBusy(), sendNoAckMsgHex(), sendAckMsgHex() and getFWVersion(), 
+ *          and report transmissions with \ref beginTx() and \ref endTx().
+ * @tparam Derived - radio backend (RHF76, RN2483 or SX127x).
+ * @tparam Log - logging policy (\ref LoRaSerialLog or \ref LoRaNoLog).
+ */
+template <class Derived, class Log>
+class LoRaRadio {
+    protected:
         LoRaConfig_t config;
-        bool loraBusy = false;
-        uint8_t setSerialInterface();                               
-        uint8_t setLoRaBaseBand();
-        String getLoRaBaseBandStr(LoRaBaseBand_e loraBaseBand);
-        uint8_t setLoRaSubBand();
-        uint8_t setLoRaClass();
-        String getLoRaClassStr(LoRaClass_e loraClass);
-        uint8_t setLoRaTxPwr();
-        String getLoRaTxPwrStr(LoRaTxPower_e loraTxPower);
-        uint8_t setLoRaUpDR();
-        String getLoRaUpDRStr(LoRaDR_e loraDR);
-        uint8_t setLoRaADR();
-        String getLoRaBoolStr(LoRaBool_e loraBool);
-        uint8_t setLoRaAuthMode();
-        String getLoRaAuthModeStr(LoRaAuthMode_e loraAuthMode);
-        uint8_t setLoRaDevEUI();
-        uint8_t setLoRaAppEUI();
-        uint8_t setLoRaDevAddr();
-        uint8_t setLoRaNwkSKey();
-        uint8_t setLoRaAppSKey();
-        uint8_t resetLoRaModule();
-
-    public:              
-        uint8_t init(LoRaConfig_t config);
-        String getFWVersion(); 
-        // bool sendNoAckMsg(LoRaConfig_t loraCfg, uint8_t port, String buf);
-        // bool sendAckMsg(LoRaConfig_t loraCfg, uint8_t port, String buf);
-        uint8_t sendNoAckMsgHex(uint8_t port, String buf);
-        // bool sendAckMsgHex(LoRaConfig_t loraCfg, uint8_t port, String buf);
-        // void callback_RX();
+        LoRaTxStatus_e txStatus = LORA_TX_IDLE;
+        uint8_t lastError = LORA_STATUS_OK;
+        LoRaTxCallback_t txCallback = NULL;
+        uint8_t msgCount = 0;
+        LoRaJoinStatus_e joinStatus = LORA_NOT_JOINED;
+        LoRaRxHandlerEntry_t rxHandlers[LORA_MAX_RX_HANDLERS];
+        uint8_t rxHandlersCount = 0;
+        uint8_t rxBuffer[LORA_MAX_PAYLOAD_SIZE];
+        uint8_t rxSize = 0;
+        uint8_t rxPort = 0;
+        bool rxPending = false;
+        int32_t airtimeCredit = 0;
+        uint32_t airtimeUpdate = 0;
+        uint8_t downlinkCount = 0;      // Downlinks requested in the current window
+        uint32_t downlinkStart = 0;
+        LoRaDR_e currentDR = DR0;       // Uplink datarate (may be changed by ADR)
+        LoRaLinkStats_t linkStats[LORA_LINK_STATS_SIZE];
+        uint8_t linkStatsHead = 0;
+        uint8_t linkStatsCount = 0;
+        LoRaLinkStats_t linkCurrent;
+        uint32_t gpsTime = 0;
+        uint32_t gpsMillis = 0;
+        bool timeSynced = false;
+        bool timeReqSent = false;
+        uint8_t timeToken = 0;
+        uint32_t timeReqTime = 0;
+        uint32_t timeReqMillis = 0;
+        bool versionAnsPending = false;
+        bool periodAnsPending = false;
+        Derived& derived() { return *static_cast<Derived*>(this); }
+        void setConfig(const LoRaConfig_t& config);
+        uint8_t checkTxAllowed(size_t size);
+        void beginTx(size_t size, bool confirmed);
+        void endTx(uint8_t statusCode);
+        void receiveDownlink(uint8_t port, const uint8_t* buf, uint8_t size);
+        void callback_RX();
+        void updateAirtime();
+        void spendAirtime(size_t size);
+        bool isDownlinkAvailable();
+        void spendDownlink();
+        void addLinkStats(uint8_t statusCode);
+        void parseTimeSync(const uint8_t* buf, uint8_t size);
+        bool isTimeReqDue();
+        uint16_t getConfigCRC();
+        bool isConfigSaved();
+        void saveConfigRecord(bool valid);
+        int8_t loadFCnt(LoRaFCntRecord_t& record);
+        void saveFCnt(uint32_t uplink, uint32_t downlink);
+
+    public:
+        bool isJoined();
+        LoRaJoinStatus_e getJoinStatus();
+        LoRaTxStatus_e getTxStatus();
+        uint8_t getLastError();
+        void setTxCallback(LoRaTxCallback_t callback);
+        uint32_t getTimeOnAir(size_t size);
+        uint32_t getAirtimeWait(size_t size);
+        uint8_t getMaxPayloadSize();
+        bool getLinkStats(uint8_t index, LoRaLinkStats_t& stats);
+        uint8_t getLinkHealth(uint8_t* buf);
+        uint8_t sendMsgHex(uint8_t port, const uint8_t* buf, size_t size);
+        uint8_t setRxHandler(uint8_t port, LoRaRxHandler_t handler);
+        bool isTimeSynced();
+        bool isTimeSyncDue();
+        uint32_t getGpsTime(uint32_t ms);
+        uint8_t requestTimeSync();
 };
 
-    
-
-    // // Set LoRa channel 0 configuration
-    // if (loraConfig.debug) {
-    //     Serial.print("\nSetting LoRa channel 0 configuration... ");
-    //     Serial.flush();
-    // }
-    // loraReturn = "";
-    // at_cmd = "AT+CH=0,";
-    // at_cmd.concat(loraConfig.chan0_freq);
-    // at_cmd.concat(",");
-    // at_cmd.concat(loraDR_toString(loraConfig.chan0_dr));
-    // Serial1.println(at_cmd);
-    // loraReturn = Serial1.readString();
-    // if (loraConfig.debug) {
-    //     Serial.print("\n\t");
-    //     Serial.print(loraReturn);
-    //     Serial.flush();        
-    // }
-
-    // // Set LoRa channel 1 configuration
-    // if (loraConfig.debug) {
-    //     Serial.print("\nSetting LoRa channel 1 configuration... ");
-    //     Serial.flush();
-    // }
-    // loraReturn = "";
-    // at_cmd = "AT+CH=1,";
-    // at_cmd.concat(loraConfig.chan1_freq);
-    // at_cmd.concat(",");
-    // at_cmd.concat(loraDR_toString(loraConfig.chan1_dr));
-    // Serial1.println(at_cmd);
-    // loraReturn = Serial1.readString();
-    // if (loraConfig.debug) {
-    //     Serial.print("\n\t");
-    //     Serial.print(loraReturn);
-    //     Serial.flush();        
-    // }
-
-    // // Set LoRa RX window 2
-    // if (loraConfig.debug) {
-    //     Serial.print("\nSetting LoRa RX window 2... ");
-    //     Serial.flush();
-    // }
-    // loraReturn = "";
-    // at_cmd = "AT+RXWIN2=";
-    // at_cmd.concat(loraConfig.rxwin2_freq);
-    // at_cmd.concat(",");
-    // at_cmd.concat(loraDR_toString(loraConfig.rxwin2_dr));
-    // Serial1.println(at_cmd);
-    // loraReturn = Serial1.readString();
-    // if (loraConfig.debug) {
-    //     Serial.print("\n\t");
-    //     Serial.print(loraReturn);
-    //     Serial.flush();        
-    // }
-
-    
-
-    
-
-    
-
-    // // // Set LoRa unconfirmed message repeats time
-    // // if (loraConfig.debug) {
-    // //     Serial.print("\nSetting LoRa unconfirmed message repeats time... ");
-    // //     Serial.flush();
-    // // }
-    // // loraReturn = "";
-    // // at_cmd = "AT+REPT=";
-    // // at_cmd.concat(loraConfig.repeat);
-    // // Serial1.println(at_cmd);
-    // // loraReturn = Serial1.readString();
-    // // if (loraConfig.debug) {
-    // //     Serial.print("\n\t");
-    // //     Serial.print(loraReturn);
-    // //     Serial.flush();        
-    // // }
-
-    // // Set LoRa confirmed message retry times
-    // if (loraConfig.debug) {
-    //     Serial.print("\nSetting LoRa confirmed message retry times... ");
-    //     Serial.flush();
-    // }
-    // loraReturn = "";
-    // at_cmd = "AT+RETRY=";
-    // at_cmd.concat(loraConfig.retry);
-    // Serial1.println(at_cmd);
-    // loraReturn = Serial1.readString();
-    // if (loraConfig.debug) {
-    //     Serial.print("\n\t");
-    //     Serial.print(loraReturn);
-    //     Serial.flush();        
-    // }
-
-    
-
-    // // Set another LoRa parameters based on authentication mode
-    // // Authentication LWABP
-    // if (loraAuthMode_toString(loraConfig.auth_mode).compareTo("LWABP") == 0) {
-
-
-    // } else {
-    //     // Authentication OTAA
-    //     // Set LoRa application key
-    //     if (loraConfig.debug) {
-    //         Serial.print("\nSetting LoRa application key... ");
-    //         Serial.flush();
-    //     }
-    //     loraReturn = "";
-    //     at_cmd = "AT+KEY=AppKey,\"";
-    //     at_cmd.concat(loraConfig.app_key);
-    //     at_cmd.concat("\"");
-    //     Serial1.println(at_cmd);
-    //     loraReturn = Serial1.readString();
-    //     if (loraConfig.debug) {
-    //         Serial.print("\n\t");
-    //         Serial.print(loraReturn);
-    //         Serial.flush();        
-    //     }
-
-    //     // Join to the LoRa network
-    //     if (loraConfig.debug) {
-    //         Serial.print("\nJoining... ");
-    //         Serial.flush();
-    //     }
-    //     loraReturn = "";
-    //     at_cmd = "AT+Join";
-    //     loraBusy = true;
-    //     Serial1.println(at_cmd);
-    //     loraReturn = Serial1.readString();
-    //     do {
-    //         while (Serial1.available()) {
-    //             loraReturn = Serial1.readString();
-    //             if (loraConfig.debug) {
-    //                 Serial.print("\n");
-    //                 Serial.print(loraReturn);
-    //                 Serial.flush();        
-    //             }
-    //             char str[30];
-    //             loraReturn.toCharArray(str, sizeof(str), 0);
-    //             if (strstr(str, "Done")) {
-    //                 loraBusy = false;
-    //             }
-    //         }  
-    //     } while (loraBusy);
-
-    // }
-
-    // Return success initialization
-//     return true;
-// }
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-// /**
-//  * @fn sendNoAckMsg(uint8_t port, char* msg_ptr, uint8_t msg_size)
-//  * @brief Send unconfirmed messages in a string format.
-//  * @param[in] port - LoRa port used to send message.
-//  * @param[in] msg_ptr - pointer to message.
-//  * @param[in] msg_size - message size.
-//  * @retval true - successful transmission.
-//  * @retval false - transmission fail.
-//  */ 
-// bool LoRa::sendNoAckMsg(LoRaConfig_t loraCfg, uint8_t port, String buf) {
-
-//     String at_cmd = "";
-
-//     // Set LoRa port
-//     if (loraCfg.debug) {
-//         Serial.print("\nSetting LoRa port... ");
-//         Serial.flush();
-//     }
-//     loraReturn = "";
-//     at_cmd = "AT+PORT=";
-//     at_cmd.concat(toAscii(port));
-//     Serial1.println(at_cmd);
-//     loraReturn = Serial1.readString();
-//     if (loraCfg.debug) {
-//         Serial.print("\n\t");
-//         Serial.print(loraReturn);
-//         Serial.flush();        
-//     }
-
-//     // Send LoRa message
-//     if (loraCfg.debug) {
-//         Serial.print("\nSending unconfirmed LoRa string message... ");
-//         Serial.flush();
-//     }
-//     loraReturn = "";
-//     at_cmd = "AT+MSG=\"";
-//     at_cmd.concat(buf);
-//     at_cmd.concat("\"");
-//     Serial1.println(at_cmd);
-//     loraReturn = Serial1.readString();
-//     if (loraCfg.debug) {
-//         Serial.print("\n\t");
-//         Serial.print(loraReturn);
-//         Serial.flush();        
-//     }
-
-//     return true;
-// }
-
-// /**
-//  * @fn sendAckMsg(uint8_t port, char* msg_ptr, uint8_t msg_size)
-//  * @brief Send confirmed messages in a string format.
-//  * @param[in] port - LoRa port used to send message.
-//  * @param[in] msg_ptr - pointer to message.
-//  * @param[in] msg_size - message size.
-//  * @retval true - successful transmission.
-//  * @retval false - transmission fail.
-//  */ 
-// bool LoRa::sendAckMsg(LoRaConfig_t loraCfg, uint8_t port, String buf) {
-
-//     String at_cmd = "";
-
-//     // Set LoRa port
-//     if (loraCfg.debug) {
-//         Serial.print("\nSetting LoRa port... ");
-//         Serial.flush();
-//     }
-//     loraReturn = "";
-//     at_cmd = "AT+PORT=";
-//     at_cmd.concat(toAscii(port));
-//     Serial1.println(at_cmd);
-//     loraReturn = Serial1.readString();
-//     if (loraCfg.debug) {
-//         Serial.print("\n\t");
-//         Serial.print(loraReturn);
-//         Serial.flush();        
-//     }
-
-//     // Send LoRa message
-//     if (loraCfg.debug) {
-//         Serial.print("\nSending confirmed LoRa string message... ");
-//         Serial.flush();
-//     }
-//     loraReturn = "";
-//     at_cmd = "AT+CMSG=\"";
-//     at_cmd.concat(buf);
-//     at_cmd.concat("\"");
-//     Serial1.println(at_cmd);
-//     loraReturn = Serial1.readString();
-//     if (loraCfg.debug) {
-//         Serial.print("\n");
-//         Serial.print(loraReturn);
-//         Serial.flush();        
-//     }
-
-//     return true;
-// }
-
-
-
-// /**
-//  * @fn sendAckMsgHex(uint8_t port, char* msg_ptr, uint8_t msg_size)
-//  * @brief Send confirmed messages in a hexadecimal format.
-//  * @param[in] port - LoRa port used to send message.
-//  * @param[in] msg_ptr - pointer to message.
-//  * @param[in] msg_size - message size.
-//  * @retval true - successful transmission.
-//  * @retval false - transmission fail.
-//  */ 
-// bool LoRa::sendAckMsgHex(LoRaConfig_t loraCfg, uint8_t port, String buf) {
-
-//     String at_cmd = "";
-
-//     // Set LoRa modem as busy
-//     loraBusy = true;
-
-//     // Set LoRa port
-//     if (loraCfg.debug) {
-//         Serial.print("\nSetting LoRa port... ");
-//         Serial.flush();
-//     }
-//     loraReturn = "";
-//     at_cmd = "AT+PORT=";
-//     at_cmd.concat(toAscii(port));
-//     Serial1.println(at_cmd);
-//     loraReturn = Serial1.readString();
-//     if (loraCfg.debug) {
-//         Serial.print("\n\t");
-//         Serial.print(loraReturn);
-//         Serial.flush();        
-//     }
-
-//     // Send LoRa message
-//     if (loraCfg.debug) {
-//         Serial.print("\nSending confirmed LoRa hexadecimal message... ");
-//         Serial.flush();
-//     }
-//     loraReturn = "";
-//     at_cmd = "AT+CMSGHEX=\"";
-//     at_cmd.concat(buf);
-//     at_cmd.concat("\"");
-//     Serial1.println(at_cmd);
-//     do {
-//         while (Serial1.available()) {
-//             loraReturn = Serial1.readString();
-//             if (loraCfg.debug) {
-//                 Serial.print("\n");
-//                 Serial.print(loraReturn);
-//                 Serial.flush();        
-//             }
-//             char str[1024];
-//             loraReturn.toCharArray(str, sizeof(str), 0);
-//             if (strstr(str, "Done")) {
-//                 loraBusy = false;
-//             }
-//         }  
-//     } while (loraBusy);
-
-//     return true;
-// }
-
-// /**
-//  * @fn loraSerialRx_callback()
-//  * @brief Callback to process data from LoRa modem.
-//  */
-// void LoRa::callback_RX() {
-//     // while (Serial1.available()) {    
-//     //     loraReturn = Serial1.readString();
-//     //     // if (loraConfig.debug) {
-//     //         Serial.print("\n");
-//     //         Serial.print(loraReturn);
-//     //         Serial.flush();
-//     //     // }
-//     // }
-// }
-
-#endif // __LORA_H_
\ No newline at end of file
+/*******************************************************
+ *             FUNCTIONS IMPLEMENTATIONS
+ *******************************************************/
+
+/**
+ * @fn LoRaRadio::setConfig(const LoRaConfig_t& config)
+ * @brief Keep the configuration and start the airtime budget (called by backends init()).
+ */
+template <class Derived, class Log>
+void LoRaRadio<Derived, Log>::setConfig(const LoRaConfig_t& config) {
+    this->config = config;
+    this->currentDR = config.uplink_dr;
+    this->airtimeCredit = this->config.airtime_budget;
+    this->airtimeUpdate = millis();
+    this->downlinkCount = 0;
+    this->downlinkStart = this->airtimeUpdate;
+}
+
+/**
+ * @fn LoRaRadio::getConfigCRC()
+ * @brief Compute the CRC-16/CCITT fingerprint of the radio related configuration.
+ */
+template <class Derived, class Log>
+uint16_t LoRaRadio<Derived, Log>::getConfigCRC() {
+    uint8_t fields[] = {
+        LORA_CONFIG_VERSION,
+        (uint8_t)this->config.baseband,
+        this->config.subband,
+        (uint8_t)this->config.op_class,
+        (uint8_t)this->config.tx_power,
+        (uint8_t)this->config.uplink_dr,
+        (uint8_t)this->config.adr,
+        (uint8_t)this->config.auth_mode
+    };
+    uint16_t crc = crc16(0xFFFF, fields, sizeof(fields));
+    crc = crc16(crc, (const uint8_t*)this->config.dev_eui.c_str(), this->config.dev_eui.length());
+    crc = crc16(crc, (const uint8_t*)this->config.dev_addr.c_str(), this->config.dev_addr.length());
+    crc = crc16(crc, (const uint8_t*)this->config.nwks_key.c_str(), this->config.nwks_key.length());
+    crc = crc16(crc, (const uint8_t*)this->config.apps_key.c_str(), this->config.apps_key.length());
+    crc = crc16(crc, (const uint8_t*)this->config.app_eui.c_str(), this->config.app_eui.length());
+    crc = crc16(crc, (const uint8_t*)this->config.app_key.c_str(), this->config.app_key.length());
+
+    return crc;
+}
+
+/**
+ * @fn LoRaRadio::loadFCnt(LoRaFCntRecord_t& record)
+ * @brief Find the newest valid frame counters slot in EEPROM.
+ * @param[out] record - newest frame counters record.
+ * @return int8_t - slot index or -1 if there is no valid slot.
+ */
+template <class Derived, class Log>
+int8_t LoRaRadio<Derived, Log>::loadFCnt(LoRaFCntRecord_t& record) {
+    int8_t newest = -1;
+
+    for (uint8_t i = 0; i < LORA_FCNT_SLOTS; i++) {
+        LoRaFCntRecord_t slot;
+        EEPROM.get(this->config.eeprom_addr + LORA_EEPROM_FCNT_OFFSET + i * sizeof(LoRaFCntRecord_t), slot);
+        if (slot.crc != crc16(0xFFFF, (const uint8_t*)&slot, offsetof(LoRaFCntRecord_t, crc))) {
+            continue;
+        }
+        if ((newest < 0) || ((int16_t)(slot.seq - record.seq) > 0)) {
+            record = slot;
+            newest = i;
+        }
+    }
+
+    return newest;
+}
+
+/**
+ * @fn LoRaRadio::saveFCnt(uint32_t uplink, uint32_t downlink)
+ * @brief Save frame counters in the slot after the newest one, so EEPROM writes are 
+ *        spread over \ref LORA_FCNT_SLOTS slots.
+ */
+template <class Derived, class Log>
+void LoRaRadio<Derived, Log>::saveFCnt(uint32_t uplink, uint32_t downlink) {
+    LoRaFCntRecord_t record;
+    int8_t slot = loadFCnt(record);
+
+    record.seq = (slot < 0) ? 0 : record.seq + 1;
+    record.uplink = uplink;
+    record.downlink = downlink;
+    record.crc = crc16(0xFFFF, (const uint8_t*)&record, offsetof(LoRaFCntRecord_t, crc));
+    slot = (slot + 1) % LORA_FCNT_SLOTS;
+    EEPROM.put(this->config.eeprom_addr + LORA_EEPROM_FCNT_OFFSET + slot * sizeof(LoRaFCntRecord_t), record);
+}
+
+/**
+ * @fn LoRaRadio::isConfigSaved()
+ * @brief Check if the fingerprint stored in EEPROM matches the configuration, i.e. 
+ *        the radio was configured with it and kept its state since then.
+ */
+template <class Derived, class Log>
+bool LoRaRadio<Derived, Log>::isConfigSaved() {
+    LoRaConfigRecord_t record;
+    EEPROM.get(this->config.eeprom_addr + LORA_EEPROM_CONFIG_OFFSET, record);
+
+    return (record.magic == LORA_EEPROM_MAGIC) && (record.crc == getConfigCRC());
+}
+
+/**
+ * @fn LoRaRadio::saveConfigRecord(bool valid)
+ * @brief Store the configuration fingerprint in EEPROM.
+ * @param[in] valid - true once the radio holds the configuration, false (before it is 
+ *            configured) also invalidates the OTAA session record.
+ */
+template <class Derived, class Log>
+void LoRaRadio<Derived, Log>::saveConfigRecord(bool valid) {
+    LoRaConfigRecord_t record;
+    record.magic = valid ? LORA_EEPROM_MAGIC : 0;
+    record.crc = valid ? getConfigCRC() : 0;
+    EEPROM.put(this->config.eeprom_addr + LORA_EEPROM_CONFIG_OFFSET, record);
+
+    if (!valid) {
+        LoRaSessionRecord_t session;
+        memset(&session, 0, sizeof(session));
+        EEPROM.put(this->config.eeprom_addr + LORA_EEPROM_SESSION_OFFSET, session);
+    }
+}
+
+/**
+ * @fn LoRaRadio::checkTxAllowed(size_t size)
+ * @brief Check if a message may be sent now.
+ * @param[in] size - message size (in bytes).
+ * @retval LORA_STATUS_INVALID_PARAM - message does not fit the current datarate (see 
+ *         \ref getMaxPayloadSize()), so it will not be sent later either.
+ * @retval status code - LORA_STATUS_OK or the reason the message can not be sent now.
+ */
+template <class Derived, class Log>
+uint8_t LoRaRadio<Derived, Log>::checkTxAllowed(size_t size) {
+    if (derived().isBusy()) {
+        return LORA_STATUS_BUSY;
+    }
+    if (!isJoined()) {
+        return LORA_STATUS_NOT_JOINED;
+    }
+    if (size > getMaxPayloadSize()) {
+        return LORA_STATUS_INVALID_PARAM;
+    }
+    if (getAirtimeWait(size) != 0) {
+        return LORA_STATUS_NO_AIRTIME;
+    }
+
+    return LORA_STATUS_OK;
+}
+
+/**
+ * @fn LoRaRadio::beginTx(size_t size, bool confirmed)
+ * @brief Mark a transmission as pending (called by backends once the radio accepted it).
+ * @param[in] size - message size (in bytes).
+ * @param[in] confirmed - message is confirmed (its ACK is charged to the downlink budget).
+ */
+template <class Derived, class Log>
+void LoRaRadio<Derived, Log>::beginTx(size_t size, bool confirmed) {
+    spendAirtime(size);
+    if (confirmed) {
+        spendDownlink();
+    }
+    memset(&this->linkCurrent, 0, sizeof(this->linkCurrent));
+    this->txStatus = LORA_TX_PENDING;
+}
+
+/**
+ * @fn LoRaRadio::endTx(uint8_t statusCode)
+ * @brief Report the end of the pending transmission (link statistics, status and callback).
+ * @param[in] statusCode - transmission status code.
+ */
+template <class Derived, class Log>
+void LoRaRadio<Derived, Log>::endTx(uint8_t statusCode) {
+    addLinkStats(statusCode);
+    this->lastError = statusCode;
+    this->txStatus = (statusCode == LORA_STATUS_OK) ? LORA_TX_DONE : LORA_TX_FAILED;
+    if (Log::enabled) {
+        Log::print((this->txStatus == LORA_TX_DONE) ? F("\n\tTransmission [OK]") : F("\n\tTransmission [FAIL]"));
+        Log::flush();
+    }
+    if (this->txCallback != NULL) {
+        this->txCallback(this->txStatus, this->lastError);
+    }
+}
+
+/**
+ * @fn LoRaRadio::receiveDownlink(uint8_t port, const uint8_t* buf, uint8_t size)
+ * @brief Keep a downlink to be dispatched by \ref callback_RX().
+ */
+template <class Derived, class Log>
+void LoRaRadio<Derived, Log>::receiveDownlink(uint8_t port, const uint8_t* buf, uint8_t size) {
+    if (size > LORA_MAX_PAYLOAD_SIZE) {
+        size = LORA_MAX_PAYLOAD_SIZE;
+    }
+    memcpy(this->rxBuffer, buf, size);
+    this->rxSize = size;
+    this->rxPort = port;
+    this->rxPending = true;
+}
+
+/**
+ * @fn LoRaRadio::isJoined()
+ * @brief Check if the device may send messages (ABP or joined OTAA session).
+ */
+template <class Derived, class Log>
+bool LoRaRadio<Derived, Log>::isJoined() {
+    return this->joinStatus == LORA_JOINED;
+}
+
+/**
+ * @fn LoRaRadio::getJoinStatus()
+ * @brief Get the network join status.
+ * @return LoRaJoinStatus_e - join status.
+ */
+template <class Derived, class Log>
+LoRaJoinStatus_e LoRaRadio<Derived, Log>::getJoinStatus() {
+    return this->joinStatus;
+}
+
+/**
+ * @fn LoRaRadio::addLinkStats(uint8_t statusCode)
+ * @brief Store the statistics of the transmission that just ended in the link 
+ *        statistics ring.
+ * @param[in] statusCode - transmission status code.
+ */
+template <class Derived, class Log>
+void LoRaRadio<Derived, Log>::addLinkStats(uint8_t statusCode) {
+    this->linkCurrent.status = statusCode;
+    this->linkStats[this->linkStatsHead] = this->linkCurrent;
+    this->linkStatsHead = (this->linkStatsHead + 1) % LORA_LINK_STATS_SIZE;
+    if (this->linkStatsCount < LORA_LINK_STATS_SIZE) {
+        this->linkStatsCount++;
+    }
+}
+
+/**
+ * @fn LoRaRadio::getLinkStats(uint8_t index, LoRaLinkStats_t& stats)
+ * @brief Get the link statistics of one of the last transmissions.
+ * @param[in] index - 0 for the last transmission, 1 for the previous one...
+ * @param[out] stats - link statistics.
+ * @retval true - statistics available.
+ * @retval false - \p index is beyond the stored transmissions.
+ */
+template <class Derived, class Log>
+bool LoRaRadio<Derived, Log>::getLinkStats(uint8_t index, LoRaLinkStats_t& stats) {
+    if (index >= this->linkStatsCount) {
+        return false;
+    }
+    stats = this->linkStats[(this->linkStatsHead + LORA_LINK_STATS_SIZE - 1 - index) % LORA_LINK_STATS_SIZE];
+
+    return true;
+}
+
+/**
+ * @fn LoRaRadio::getLinkHealth(uint8_t* buf)
+ * @brief Write a compact link health block (\ref LORA_LINK_HEALTH_SIZE bytes) to be 
+ *        appended to an uplink.
+ * @details Block layout:\n
+ *          1 byte - delivered (high nibble) and total (low nibble) transmissions in the ring\n
+ *          1 byte - last downlink RSSI (-dBm, 0 = no downlink)\n
+ *          1 byte - last downlink SNR (int8, dB)\n
+ *          1 byte - last link margin (dB, 0xFF = no link check answer)\n
+ *          1 byte - last gateway count
+ * @param[out] buf - block buffer.
+ * @return uint8_t - block size (in bytes).
+ */
+template <class Derived, class Log>
+uint8_t LoRaRadio<Derived, Log>::getLinkHealth(uint8_t* buf) {
+    LoRaLinkStats_t stats;
+    uint8_t delivered = 0;
+    bool rssiFound = false;
+    bool linkFound = false;
+
+    buf[1] = 0;
+    buf[2] = 0;
+    buf[3] = 0xFF;
+    buf[4] = 0;
+    for (uint8_t i = 0; getLinkStats(i, stats); i++) {
+        if (stats.status == LORA_STATUS_OK) {
+            delivered++;
+        }
+        if (!rssiFound && (stats.flags & LORA_LINK_RSSI)) {
+            rssiFound = true;
+            buf[1] = (stats.rssi < -255) ? 255 : (uint8_t)(-stats.rssi);
+            buf[2] = (uint8_t)stats.snr;
+        }
+        if (!linkFound && (stats.flags & LORA_LINK_CHECK)) {
+            linkFound = true;
+            buf[3] = stats.margin;
+            buf[4] = stats.gateways;
+        }
+    }
+    buf[0] = (delivered << 4) | this->linkStatsCount;
+
+    return LORA_LINK_HEALTH_SIZE;
+}
+
+/**
+ * @fn LoRaRadio::callback_RX()
+ * @brief Dispatch the last received downlink to the handler of its port.
+ * @details Called from \ref poll() after the modem lines were processed, so handlers 
+ *          may send AT commands.
+ */
+template <class Derived, class Log>
+void LoRaRadio<Derived, Log>::callback_RX() {
+    if (!this->rxPending) {
+        return;
+    }
+    this->rxPending = false;
+
+    if (Log::enabled) {
+        Log::print(F("\n\tDownlink received on port "));
+        Log::print(this->rxPort);
+        Log::print(F(" ("));
+        Log::print(this->rxSize);
+        Log::print(F(" bytes)"));
+        Log::flush();
+    }
+
+    if (this->rxPort == LORA_CLOCK_SYNC_PORT) {
+        parseTimeSync(this->rxBuffer, this->rxSize);
+        return;
+    }
+    for (uint8_t i = 0; i < this->rxHandlersCount; i++) {
+        if (this->rxHandlers[i].port == this->rxPort) {
+            this->rxHandlers[i].handler(this->rxPort, this->rxBuffer, this->rxSize);
+            return;
+        }
+    }
+}
+
+/**
+ * @fn LoRaRadio::setRxHandler(uint8_t port, LoRaRxHandler_t handler)
+ * @brief Register the function called when a downlink is received on \p port.
+ * @param[in] port - LoRa port (1 - 223).
+ * @param[in] handler - handler function (replaces the one already registered on the port).
+ * @retval LORA_STATUS_OK - handler registered.
+ * @retval LORA_STATUS_INVALID_PARAM - no handler or handlers table is full.
+ */
+template <class Derived, class Log>
+uint8_t LoRaRadio<Derived, Log>::setRxHandler(uint8_t port, LoRaRxHandler_t handler) {
+    if (handler == NULL) {
+        return LORA_STATUS_INVALID_PARAM;
+    }
+
+    for (uint8_t i = 0; i < this->rxHandlersCount; i++) {
+        if (this->rxHandlers[i].port == port) {
+            this->rxHandlers[i].handler = handler;
+            return LORA_STATUS_OK;
+        }
+    }
+
+    if (this->rxHandlersCount >= LORA_MAX_RX_HANDLERS) {
+        return LORA_STATUS_INVALID_PARAM;
+    }
+    this->rxHandlers[this->rxHandlersCount].port = port;
+    this->rxHandlers[this->rxHandlersCount].handler = handler;
+    this->rxHandlersCount++;
+
+    return LORA_STATUS_OK;
+}
+
+/**
+ * @fn LoRaRadio::getTxStatus()
+ * @brief Get the status of the last transmission.
+ * @return LoRaTxStatus_e - transmission status.
+ */
+template <class Derived, class Log>
+LoRaTxStatus_e LoRaRadio<Derived, Log>::getTxStatus() {
+    return this->txStatus;
+}
+
+/**
+ * @fn LoRaRadio::getLastError()
+ * @brief Get the status code of the last finished transmission.
+ * @return uint8_t - LORA_STATUS_OK or error code (see \ref LoRaStatusCode_e).
+ */
+template <class Derived, class Log>
+uint8_t LoRaRadio<Derived, Log>::getLastError() {
+    return this->lastError;
+}
+
+/**
+ * @fn LoRaRadio::setTxCallback(LoRaTxCallback_t callback)
+ * @brief Register a function called (from \ref poll()) when a transmission ends.
+ * @param[in] callback - callback function or NULL to disable it.
+ */
+template <class Derived, class Log>
+void LoRaRadio<Derived, Log>::setTxCallback(LoRaTxCallback_t callback) {
+    this->txCallback = callback;
+}
+
+/**
+ * @fn LoRaRadio::getTimeOnAir(size_t size)
+ * @brief Compute the time on air of an uplink sent at the current datarate (see 
+ *        \ref getMaxPayloadSize()) with explicit header, CRC on, coding rate 4/5 and 
+ *        8 symbols preamble.
+ * @param[in] size - application payload size (in bytes).
+ * @return uint32_t - time on air (in ms), 0 if the datarate is not defined in the base band.
+ */
+template <class Derived, class Log>
+uint32_t LoRaRadio<Derived, Log>::getTimeOnAir(size_t size) {
+    uint8_t dr = this->currentDR;
+    uint8_t sf = 0;
+    uint16_t bw = 125;
+    uint16_t phySize = size + LORA_PHY_OVERHEAD;
+
+    if (this->config.baseband == EU868) {
+        if (dr <= DR5) {
+            sf = 12 - dr;
+        } else if (dr == DR6) {
+            sf = 7;
+            bw = 250;
+        } else if (dr == DR7) {
+            // FSK 50 kbps: preamble (5), sync word (3), length (1) and CRC (2) bytes
+            return ((phySize + 11) * 160UL + 999) / 1000;
+        }
+    } else {
+        if (dr <= DR3) {
+            sf = 10 - dr;
+        } else if (dr == DR4) {
+            sf = 8;
+            bw = 500;
+        } else if ((dr >= DR8) && (dr <= DR13)) {
+            sf = 12 - (dr - DR8);
+            bw = 500;
+        }
+    }
+    if (sf == 0) {
+        return 0;
+    }
+
+    // Symbol time (in us) and payload symbols (see Semtech AN1200.13)
+    uint32_t symbolTime = ((uint32_t)1 << sf) * 1000 / bw;
+    uint8_t blockBits = 4 * (((sf >= 11) && (bw == 125)) ? (sf - 2) : sf);
+    int16_t bits = 8 * phySize - 4 * sf + 28 + 16;
+    uint16_t symbols = 8;
+    if (bits > 0) {
+        symbols += ((bits + blockBits - 1) / blockBits) * 5;
+    }
+
+    return ((49 * symbolTime) / 4 + symbols * symbolTime + 999) / 1000;
+}
+
+/**
+ * @fn LoRaRadio::updateAirtime()
+ * @brief Refill the airtime credit at \ref LoRaConfig_t::airtime_budget per 
+ *        \ref LoRaConfig_t::airtime_window, up to one full budget.
+ */
+template <class Derived, class Log>
+void LoRaRadio<Derived, Log>::updateAirtime() {
+    if ((this->config.airtime_budget == 0) || (this->config.airtime_window == 0)) {
+        return;
+    }
+
+    uint32_t now = millis();
+    uint32_t refill = (uint64_t)(now - this->airtimeUpdate) * this->config.airtime_budget / this->config.airtime_window;
+    if (refill == 0) {
+        return;
+    }
+    this->airtimeUpdate = now;
+    if (refill > this->config.airtime_budget) {
+        refill = this->config.airtime_budget;
+    }
+    this->airtimeCredit += (int32_t)refill;
+    if (this->airtimeCredit > (int32_t)this->config.airtime_budget) {
+        this->airtimeCredit = this->config.airtime_budget;
+    }
+}
+
+/**
+ * @fn LoRaRadio::spendAirtime(size_t size)
+ * @brief Charge the time on air of a transmission attempt to the airtime credit 
+ *        (retries may leave it negative, delaying the next messages).
+ * @param[in] size - application payload size (in bytes).
+ */
+template <class Derived, class Log>
+void LoRaRadio<Derived, Log>::spendAirtime(size_t size) {
+    updateAirtime();
+    this->airtimeCredit -= getTimeOnAir(size);
+}
+
+/**
+ * @fn LoRaRadio::isDownlinkAvailable()
+ * @brief Check if optional downlinks (periodic confirmations and link checks) may still 
+ *        be requested in the current window.
+ * @details Downlinks are counted per \ref LoRaConfig_t::airtime_window (the TTN fair use
+ *          policy allows 10 per day). Messages the application explicitly confirms are 
+ *          always sent and counted, so optional downlinks only use what they left.
+ * @retval true - fewer than \ref LoRaConfig_t::downlink_budget downlinks requested.
+ * @retval false - downlink budget spent.
+ */
+template <class Derived, class Log>
+bool LoRaRadio<Derived, Log>::isDownlinkAvailable() {
+    if ((this->config.downlink_budget == 0) || (this->config.airtime_window == 0)) {
+        return true;
+    }
+
+    uint32_t now = millis();
+    if ((now - this->downlinkStart) >= this->config.airtime_window) {
+        this->downlinkCount = 0;
+        this->downlinkStart = now;
+    }
+
+    return this->downlinkCount < this->config.downlink_budget;
+}
+
+/**
+ * @fn LoRaRadio::spendDownlink()
+ * @brief Count a downlink requested in the current window (see \ref isDownlinkAvailable()).
+ */
+template <class Derived, class Log>
+void LoRaRadio<Derived, Log>::spendDownlink() {
+    isDownlinkAvailable();
+    if (this->downlinkCount < 0xFF) {
+        this->downlinkCount++;
+    }
+}
+
+/**
+ * @fn LoRaRadio::getAirtimeWait(size_t size)
+ * @brief Get how long an uplink must be deferred to fit in the airtime budget.
+ * @param[in] size - application payload size (in bytes).
+ * @return uint32_t - delay (in ms), 0 if the uplink may be sent now.
+ */
+template <class Derived, class Log>
+uint32_t LoRaRadio<Derived, Log>::getAirtimeWait(size_t size) {
+    if ((this->config.airtime_budget == 0) || (this->config.airtime_window == 0)) {
+        return 0;
+    }
+
+    // Message longer than the whole budget waits for a full budget
+    int32_t timeOnAir = getTimeOnAir(size);
+    if (timeOnAir > (int32_t)this->config.airtime_budget) {
+        timeOnAir = this->config.airtime_budget;
+    }
+
+    updateAirtime();
+    if (timeOnAir <= this->airtimeCredit) {
+        return 0;
+    }
+
+    return (uint64_t)(timeOnAir - this->airtimeCredit) * this->config.airtime_window / this->config.airtime_budget + 1;
+}
+
+/**
+ * @fn LoRaRadio::getMaxPayloadSize()
+ * @brief Get the maximum application payload at the current uplink datarate (no
+ *        MAC commands piggybacked), limited to \ref LORA_MAX_PAYLOAD_SIZE.
+ * @details Datarate starts at \ref LoRaConfig_t::uplink_dr. With ADR, backends read the 
+ *          datarate set by the network after each transmission (see 
+ *          \ref getLoRaMaxPayloadSize()).
+ * @return uint8_t - maximum payload size (in bytes).
+ */
+template <class Derived, class Log>
+uint8_t LoRaRadio<Derived, Log>::getMaxPayloadSize() {
+    return getLoRaMaxPayloadSize(this->config.baseband, this->currentDR);
+}
+
+/**
+ * @fn sendMsgHex(uint8_t port, const uint8_t* buf, size_t size)
+ * @brief Send binary messages, confirming one of every \ref LoRaConfig_t::confirm_every 
+ *        messages (never if it is 0) while the downlink budget allows it (see 
+ *        \ref isDownlinkAvailable()), otherwise the next message is confirmed.
+ * @param[in] port - LoRa port used to send message.
+ * @param[in] buf - pointer to message.
+ * @param[in] size - message size (in bytes).
+ * @retval status code - LORA_STATUS_OK if transmission started or error code.
+ */ 
+template <class Derived, class Log>
+uint8_t LoRaRadio<Derived, Log>::sendMsgHex(uint8_t port, const uint8_t* buf, size_t size) {
+    uint8_t statusCode = LORA_STATUS_OK;
+    bool confirmed = (this->config.confirm_every != 0) && 
+                     ((this->msgCount + 1) >= this->config.confirm_every) && isDownlinkAvailable();
+
+    if (confirmed) {
+        statusCode = derived().sendAckMsgHex(port, buf, size);
+    } else {
+        statusCode = derived().sendNoAckMsgHex(port, buf, size);
+    }
+    if (statusCode == LORA_STATUS_OK) {
+        if (confirmed) {
+            this->msgCount = 0;
+        } else if (this->msgCount < 0xFF) {
+            this->msgCount++;
+        }
+    }
+
+    return statusCode;
+}
+
+/**
+ * @fn LoRaRadio::isTimeSynced()
+ * @brief Check if the clock was synchronized with the network.
+ */
+template <class Derived, class Log>
+bool LoRaRadio<Derived, Log>::isTimeSynced() {
+    return this->timeSynced;
+}
+
+/**
+ * @fn LoRaRadio::isTimeSyncDue()
+ * @brief Check if a clock synchronization uplink should be sent (see \ref isTimeReqDue()), 
+ *        or an answer to a clock synchronization command is pending.
+ */
+template <class Derived, class Log>
+bool LoRaRadio<Derived, Log>::isTimeSyncDue() {
+    return this->versionAnsPending || this->periodAnsPending || isTimeReqDue();
+}
+
+/**
+ * @fn LoRaRadio::isTimeReqDue()
+ * @brief Check if an AppTimeReq should be sent (never requested, request not answered 
+ *        after \ref LORA_TIME_SYNC_RETRY or clock older than \ref LoRaConfig_t::time_sync_period).
+ */
+template <class Derived, class Log>
+bool LoRaRadio<Derived, Log>::isTimeReqDue() {
+    if (this->config.time_sync_period == 0) {
+        return false;
+    }
+    if (!this->timeReqSent) {
+        return true;
+    }
+
+    return (millis() - this->timeReqMillis) >= (this->timeSynced ? this->config.time_sync_period : LORA_TIME_SYNC_RETRY);
+}
+
+/**
+ * @fn LoRaRadio::getGpsTime(uint32_t ms)
+ * @brief Convert a local time to GPS time (seconds since 1980-01-06 00:00:00 UTC).
+ * @details Before the first synchronization, it is the up time (in s).
+ * @param[in] ms - local time (millis()), may be before the last synchronization.
+ * @return uint32_t - GPS time (in s).
+ */
+template <class Derived, class Log>
+uint32_t LoRaRadio<Derived, Log>::getGpsTime(uint32_t ms) {
+    return this->gpsTime + (int32_t)(ms - this->gpsMillis) / 1000;
+}
+
+/**
+ * @fn LoRaRadio::requestTimeSync()
+ * @brief Send an AppTimeReq (LoRaWAN TS003 clock synchronization, port 
+ *        \ref LORA_CLOCK_SYNC_PORT) as an unconfirmed message, after the pending 
+ *        answers to clock synchronization commands (see \ref parseTimeSync()).
+ * @details Works with any backend, since AppTimeAns is a regular downlink (handled 
+ *          before the port handlers). The clock is set when the answer with the same 
+ *          token arrives. If answers are pending and the clock is not due (see 
+ *          \ref isTimeReqDue()), only the answers are sent.
+ * @retval status code - LORA_STATUS_OK if transmission started or error code.
+ */
+template <class Derived, class Log>
+uint8_t LoRaRadio<Derived, Log>::requestTimeSync() {
+    uint8_t buf[LORA_TIME_SYNC_MAX_SIZE];
+    uint8_t size = 0;
+    uint32_t ms = millis();
+    uint32_t deviceTime = getGpsTime(ms);
+    uint8_t token = (this->timeToken + 1) & 0x0F;
+    bool timeReq = (!this->versionAnsPending && !this->periodAnsPending) || isTimeReqDue();
+
+    // PackageVersionAns: CID, PackageIdentifier (clock synchronization) and PackageVersion
+    if (this->versionAnsPending) {
+        buf[size++] = 0x00;
+        buf[size++] = 1;
+        buf[size++] = 1;
+    }
+    // DeviceAppTimePeriodicityAns: CID, Status (period applied) and Time (LSB first)
+    if (this->periodAnsPending) {
+        buf[size++] = 0x02;
+        buf[size++] = 0x00;
+        buf[size++] = deviceTime & 0xFF;
+        buf[size++] = (deviceTime >> 8) & 0xFF;
+        buf[size++] = (deviceTime >> 16) & 0xFF;
+        buf[size++] = (deviceTime >> 24) & 0xFF;
+    }
+    // AppTimeReq: CID, DeviceTime (LSB first) and Param (AnsRequired, TokenReq)
+    if (timeReq) {
+        buf[size++] = 0x01;
+        buf[size++] = deviceTime & 0xFF;
+        buf[size++] = (deviceTime >> 8) & 0xFF;
+        buf[size++] = (deviceTime >> 16) & 0xFF;
+        buf[size++] = (deviceTime >> 24) & 0xFF;
+        buf[size++] = 0x10 | token;
+    }
+
+    uint8_t statusCode = derived().sendNoAckMsgHex(LORA_CLOCK_SYNC_PORT, buf, size);
+    if (statusCode == LORA_STATUS_OK) {
+        this->versionAnsPending = false;
+        this->periodAnsPending = false;
+        if (timeReq) {
+            spendDownlink();
+            this->timeToken = token;
+            this->timeReqTime = deviceTime;
+            this->timeReqMillis = ms;
+            this->timeReqSent = true;
+        }
+    }
+
+    return statusCode;
+}
+
+/**
+ * @fn LoRaRadio::parseTimeSync(const uint8_t* buf, uint8_t size)
+ * @brief Handle clock synchronization commands: AppTimeAns sets the clock, 
+ *        DeviceAppTimePeriodicityReq sets \ref LoRaConfig_t::time_sync_period and 
+ *        ForceDeviceResyncReq makes a new request due.
+ * @details PackageVersionReq and DeviceAppTimePeriodicityReq are answered by the next 
+ *          \ref requestTimeSync() (\ref isTimeSyncDue() is true meanwhile), since 
+ *          downlinks are handled while the application may be sending.
+ * @param[in] buf - downlink payload.
+ * @param[in] size - downlink payload size.
+ */
+template <class Derived, class Log>
+void LoRaRadio<Derived, Log>::parseTimeSync(const uint8_t* buf, uint8_t size) {
+    uint8_t i = 0;
+
+    while (i < size) {
+        uint8_t cid = buf[i++];
+        if ((cid == 0x01) && ((i + 5) <= size)) {
+            int32_t correction = (int32_t)((uint32_t)buf[i] | ((uint32_t)buf[i + 1] << 8) | 
+                                           ((uint32_t)buf[i + 2] << 16) | ((uint32_t)buf[i + 3] << 24));
+            if (this->timeReqSent && ((buf[i + 4] & 0x0F) == this->timeToken)) {
+                this->gpsTime = this->timeReqTime + correction;
+                this->gpsMillis = this->timeReqMillis;
+                this->timeSynced = true;
+                if (Log::enabled) {
+                    Log::print(F("\n\tClock synchronized, GPS time: "));
+                    Log::print(this->gpsTime);
+                    Log::flush();
+                }
+            }
+            i += 5;
+        } else if (cid == 0x00) {
+            this->versionAnsPending = true;
+        } else if ((cid == 0x02) && (i < size)) {
+            this->config.time_sync_period = LORA_TIME_PERIOD_UNIT << (buf[i] & 0x0F);
+            this->periodAnsPending = true;
+            i++;
+        } else if ((cid == 0x03) && (i < size)) {
+            this->timeReqSent = false;
+            i++;
+        } else {
+            break;
+        }
+    }
+}
+
+#endif // __LORA_H_
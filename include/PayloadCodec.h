@@ -0,0 +1,455 @@
+/**
+ * @file PayloadCodec.h
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Bit-packed uplink payload codec driven by a constexpr field schema.
+ * @details Platform neutral (only standard C headers), so the network server side
+ *          decoder builds the same file with any C++11 compiler.\n
+ *          Frame layout:\n
+ *          1 byte  - header (schema version in the high nibble, flags in the low nibble)\n
+ *          1 byte  - keyframe index (only in keyframes and delta frames)\n
+ *          N bits  - presence bitmap, one bit for each field of the frame (in \ref uplink_field_e order)\n
+ *          N bits  - present fields, in \ref uplink_field_e order\n
+ *          Fields are packed MSB first and the frame is padded with zeros to a whole byte.
+ *          Fields without samples are flagged as missing in the bitmap instead of being sent.\n
+ *          Delta frames (\ref PAYLOAD_FLAG_DELTA) write each field present in the keyframe
+ *          as a signed difference (\ref field_schema_t::deltaBits) to its keyframe raw
+ *          value, other fields are written in full.\n
+ *          Frames with \ref PAYLOAD_FLAG_STATS end with the window statistics of the
+ *          present fields (see \ref payload_stats_t), in full.
+ * @version alpha
+ * @since 17/10/2026
+ * @date 17/10/2026
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __PAYLOAD_CODEC_H__
+#define __PAYLOAD_CODEC_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "FixedPoint.h"
+
+/**
+ * @enum uplink_field_e
+ * @brief Fields of an uplink frame (bit mask). Fields are written in this order.
+ */
+enum uplink_field_e {
+    FIELD_AIR_TEMP      = 0x0001,   /**< Air temperature (in C). */
+    FIELD_AIR_HUMID     = 0x0002,   /**< Air humidity (in %). */
+    FIELD_SOIL_TEMP     = 0x0004,   /**< Soil temperature (in C). */
+    FIELD_SOIL_MOISTURE = 0x0008,   /**< Soil moisture (in %). */
+    FIELD_LEAF_MOISTURE = 0x0010,   /**< Leaf moisture (in %). */
+    FIELD_UV            = 0x0020,   /**< UV index. */
+    FIELD_LIGHT         = 0x0040,   /**< Light (in lux). */
+    FIELD_WIND_DIR      = 0x0080,   /**< Wind direction (in degrees, 8 sectors). */
+    FIELD_WIND_SPEED    = 0x0100,   /**< Wind speed (in Km/h). */
+    FIELD_RAIN          = 0x0200,   /**< Pluviometer turn arounds. */
+    FIELD_PRESSURE      = 0x0400,   /**< Pressure (in hPa). */
+    FIELD_DEV_TEMP      = 0x0800,   /**< Device temperature (in C). */
+    FIELD_POWER_SUPPLY  = 0x1000,   /**< Power supply (in V). */
+    FIELD_LINK_HEALTH   = 0x2000,   /**< LoRa link health (5 raw bytes, see LoRaRadio::getLinkHealth()). */
+    FIELD_TIMESTAMP     = 0x4000    /**< Time of the last sample (GPS minutes modulo 65535), missing until the clock is synchronized. */
+};
+
+/**
+ * \def PAYLOAD_SCHEMA_VERSION
+ * Version of the frame layout (header high nibble). It must be increased whenever
+ * the schema, the fields order or the fields of a channel change.
+ */
+#define PAYLOAD_SCHEMA_VERSION      2
+
+/**
+ * \def PAYLOAD_HEADER_SIZE
+ * Maximum size (in bytes) of the frame header (keyframe index included).
+ */
+#define PAYLOAD_HEADER_SIZE         2
+
+/**
+ * \def PAYLOAD_FLAG_RESET
+ * Header flag: first frame of the channel since the station started (counters restarted).
+ */
+#define PAYLOAD_FLAG_RESET          0x01
+
+/**
+ * \def PAYLOAD_FLAG_KEYFRAME
+ * Header flag: keyframe, the next byte is its index.
+ */
+#define PAYLOAD_FLAG_KEYFRAME       0x02
+
+/**
+ * \def PAYLOAD_FLAG_DELTA
+ * Header flag: delta frame, the next byte is the index of its keyframe.
+ */
+#define PAYLOAD_FLAG_DELTA          0x04
+
+/**
+ * \def PAYLOAD_FLAG_STATS
+ * Header flag: window statistics follow the fields.
+ */
+#define PAYLOAD_FLAG_STATS          0x08
+
+/**
+ * \def FIELD_COUNT
+ * Number of fields in \ref uplink_field_e.
+ */
+#define FIELD_COUNT                 15
+
+/**
+ * \def FIELD_LINK_HEALTH_SIZE
+ * Size (in bytes) of \ref FIELD_LINK_HEALTH.
+ */
+#define FIELD_LINK_HEALTH_SIZE      5
+
+/**
+ * @enum payload_stat_e
+ * @brief Window statistics of a field, written in this order after the fields.
+ */
+enum payload_stat_e {
+    STAT_MIN = 0,       /**< Lowest sample. */
+    STAT_MAX,           /**< Highest sample. */
+    STAT_STDDEV,        /**< Population standard deviation of the samples. */
+    STAT_COUNT          /**< Number of statistics. */
+};
+
+/**
+ * @struct field_schema_t
+ * @brief Encoding of a field: raw = round((value - offset) * scale / divisor), limited 
+ *        to \p bits (see \ref to_fixed()).
+ */
+struct field_schema_t {
+    uint8_t bits;       /**< Field width (in bits, up to 16 but \ref FIELD_LINK_HEALTH). */
+    uint8_t deltaBits;  /**< Width (in bits) of the signed difference in delta frames (0 = always in full). */
+    uint16_t scale;     /**< Raw units per value unit. */
+    uint16_t divisor;   /**< Value units per raw unit. */
+    int16_t offset;     /**< Value encoded as raw 0. */
+};
+
+/**
+ * @var field_schema
+ * @brief Field schema, indexed by field bit position (see \ref getFieldIndex()).
+ */
+constexpr field_schema_t field_schema[FIELD_COUNT] = {
+    {11, 6, 10, 1, -40},        /* FIELD_AIR_TEMP: -40.0 to 164.7 C, delta +-3.2 C */
+    {10, 7, 10, 1, 0},          /* FIELD_AIR_HUMID: 0.0 to 102.3 %, delta +-6.4 % */
+    {11, 5, 10, 1, -40},        /* FIELD_SOIL_TEMP: -40.0 to 164.7 C, delta +-1.6 C */
+    {7, 4, 1, 1, 0},            /* FIELD_SOIL_MOISTURE: 0 to 127 %, delta +-8 % */
+    {7, 5, 1, 1, 0},            /* FIELD_LEAF_MOISTURE: 0 to 127 %, delta +-16 % */
+    {4, 0, 1, 1, 0},            /* FIELD_UV: 0 to 15 */
+    {16, 0, 1, 1, 0},           /* FIELD_LIGHT: 0 to 65535 lux */
+    {3, 0, 1, 45, 0},           /* FIELD_WIND_DIR: 0 to 315 degrees (45 degrees sectors) */
+    {11, 0, 10, 1, 0},          /* FIELD_WIND_SPEED: 0.0 to 204.7 Km/h */
+    {14, 0, 1, 1, 0},           /* FIELD_RAIN: 0 to 16383 turn arounds */
+    {13, 6, 10, 1, 300},        /* FIELD_PRESSURE: 300.0 to 1119.1 hPa, delta +-3.2 hPa */
+    {11, 6, 10, 1, -40},        /* FIELD_DEV_TEMP: -40.0 to 164.7 C, delta +-3.2 C */
+    {11, 6, 100, 1, 0},         /* FIELD_POWER_SUPPLY: 0.00 to 20.47 V, delta +-0.32 V */
+    {40, 0, 1, 1, 0},           /* FIELD_LINK_HEALTH: raw bytes */
+    {16, 12, 1, 1, 0}           /* FIELD_TIMESTAMP: raw, delta +-34 hours */
+};
+
+/**
+ * @struct payload_frame_t
+ * @brief Raw values of a frame (kept by the station as keyframe, rebuilt by the decoder).
+ */
+struct payload_frame_t {
+    uint16_t present;                               /**< Fields present (bit mask). */
+    uint16_t raw[FIELD_COUNT];                      /**< Raw values, indexed by field bit position. */
+    uint8_t linkHealth[FIELD_LINK_HEALTH_SIZE];     /**< Link health block. */
+};
+
+/**
+ * @struct payload_stats_t
+ * @brief Window statistics of a frame, as raw field values (standard deviation in 
+ *        raw units, without offset).
+ * @details Statistics are written for the fields present in the frame, so the frame
+ *          sizes do not change when a field has no samples. \ref FIELD_LINK_HEALTH 
+ *          has no statistics.
+ */
+struct payload_stats_t {
+    uint16_t fields[STAT_COUNT];                /**< Fields with each statistic (bit mask, set by the channel). */
+    uint16_t raw[STAT_COUNT][FIELD_COUNT];      /**< Raw values, indexed by statistic and field bit position. */
+};
+
+/**
+ * @fn getFieldIndex
+ * @brief Get the position of a field bit (index in \ref field_schema).
+ */
+constexpr uint8_t getFieldIndex(uint16_t field) {
+    return (field & 0x0001) ? 0 : (1 + getFieldIndex(field >> 1));
+}
+
+/**
+ * @fn getPayloadHeader
+ * @brief Get the frame header byte.
+ * @param[in] flags - header flags (e.g. \ref PAYLOAD_FLAG_RESET).
+ */
+constexpr uint8_t getPayloadHeader(uint8_t flags) {
+    return (PAYLOAD_SCHEMA_VERSION << 4) | (flags & 0x0F);
+}
+
+/**
+ * @fn getPayloadBits
+ * @brief Get the maximum size (in bits) of the selected fields (all of them present and
+ *        written in full), including their presence bits.
+ * @param[in] fields - fields bit mask.
+ * @param[in] index - first field checked (recursion).
+ */
+constexpr uint16_t getPayloadBits(uint16_t fields, uint8_t index = 0) {
+    return (index >= FIELD_COUNT) ? 0 :
+           (((fields >> index) & 0x0001) ? (field_schema[index].bits + 1) : 0) + getPayloadBits(fields, index + 1);
+}
+
+/**
+ * @fn getStatsBits
+ * @brief Get the size (in bits) of a statistic of the selected fields.
+ * @param[in] fields - fields bit mask.
+ * @param[in] index - first field checked (recursion).
+ */
+constexpr uint16_t getStatsBits(uint16_t fields, uint8_t index = 0) {
+    return (index >= FIELD_COUNT) ? 0 :
+           ((((fields & ~FIELD_LINK_HEALTH) >> index) & 0x0001) ? field_schema[index].bits : 0) + getStatsBits(fields, index + 1);
+}
+
+/**
+ * @fn getPayloadSize
+ * @brief Get the maximum size (in bytes) of the selected fields, without header.
+ * @param[in] fields - fields bit mask.
+ * @param[in] statsBits - size (in bits) of the window statistics (see \ref getStatsBits()).
+ */
+constexpr uint8_t getPayloadSize(uint16_t fields, uint16_t statsBits = 0) {
+    return (getPayloadBits(fields) + statsBits + 7) / 8;
+}
+
+/**
+ * @fn encodeField
+ * @brief Get the raw value of a field (out of range values are limited to the field 
+ *        range, NaN is encoded as 0).
+ * @details Integer values are converted with integer only arithmetic.
+ * @tparam Field - field (see \ref uplink_field_e).
+ * @param[in] value - integer or floating point value.
+ */
+template <uint16_t Field, class T>
+inline uint16_t encodeField(T value) {
+    return to_fixed<field_schema[getFieldIndex(Field)].bits, field_schema[getFieldIndex(Field)].scale, false, 
+                    field_schema[getFieldIndex(Field)].divisor>(value - field_schema[getFieldIndex(Field)].offset);
+}
+
+/**
+ * @fn decodeField
+ * @brief Get the value of a field from its raw value.
+ */
+inline float decodeField(uint16_t field, uint16_t raw) {
+    const field_schema_t& schema = field_schema[getFieldIndex(field)];
+    return (float)raw * schema.divisor / schema.scale + schema.offset;
+}
+
+/**
+ * @class BitWriter
+ * @brief Pack fields MSB first in a frame buffer.
+ */
+class BitWriter {
+    private:
+        uint8_t* buf;
+        uint16_t bitPos = 0;
+
+    public:
+        explicit BitWriter(uint8_t* buf) : buf(buf) {}
+
+        /**
+         * @fn BitWriter::write(uint32_t value, uint8_t bits)
+         * @brief Write the \p bits lower bits of \p value.
+         */
+        void write(uint32_t value, uint8_t bits) {
+            while (bits > 0) {
+                bits--;
+                uint8_t mask = 0x80 >> (this->bitPos & 0x07);
+                if ((this->bitPos & 0x07) == 0) {
+                    this->buf[this->bitPos >> 3] = 0;
+                }
+                if ((value >> bits) & 0x01) {
+                    this->buf[this->bitPos >> 3] |= mask;
+                }
+                this->bitPos++;
+            }
+        }
+
+        /**
+         * @fn BitWriter::size()
+         * @brief Get the frame size (in bytes), last byte padded with zeros.
+         */
+        uint8_t size() const {
+            return (this->bitPos + 7) >> 3;
+        }
+};
+
+/**
+ * @class BitReader
+ * @brief Unpack fields MSB first from a frame.
+ */
+class BitReader {
+    private:
+        const uint8_t* buf;
+        uint8_t bufSize;
+        uint16_t bitPos = 0;
+
+    public:
+        BitReader(const uint8_t* buf, uint8_t size) : buf(buf), bufSize(size) {}
+
+        /**
+         * @fn BitReader::read(uint32_t& value, uint8_t bits)
+         * @brief Read \p bits bits (up to 32).
+         * @retval false - frame too short.
+         */
+        bool read(uint32_t& value, uint8_t bits) {
+            if ((this->bitPos + bits) > ((uint16_t)this->bufSize * 8)) {
+                return false;
+            }
+            value = 0;
+            while (bits > 0) {
+                bits--;
+                value = (value << 1) | ((this->buf[this->bitPos >> 3] >> (7 - (this->bitPos & 0x07))) & 0x01);
+                this->bitPos++;
+            }
+            return true;
+        }
+
+        /**
+         * @fn BitReader::size()
+         * @brief Get the size (in bytes) read so far, last byte included.
+         */
+        uint8_t size() const {
+            return (this->bitPos + 7) >> 3;
+        }
+};
+
+/**
+ * @fn encodePayload
+ * @brief Write the presence bitmap and the fields of a frame, after its header.
+ * @param[in] fields - fields bit mask of the frame (channel or history batch fields).
+ * @param[in] frame - raw values (only fields in \p fields are written).
+ * @param[in] keyframe - keyframe of a delta frame (NULL writes every field in full).
+ * @param[out] buf - frame buffer, after the header (at least \ref getPayloadSize() bytes).
+ * @param[in] stats - window statistics (NULL = none, otherwise set \ref PAYLOAD_FLAG_STATS).
+ * @return uint8_t - size (in bytes), 0 if a difference to the keyframe does not fit
+ *         in its width (frame must be sent as keyframe).
+ */
+inline uint8_t encodePayload(uint16_t fields, const payload_frame_t& frame, const payload_frame_t* keyframe, uint8_t* buf, 
+                             const payload_stats_t* stats = NULL) {
+    BitWriter writer(buf);
+    uint16_t present = frame.present & fields;
+
+    for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+        if (fields & (1 << i)) {
+            writer.write((present >> i) & 0x01, 1);
+        }
+    }
+
+    for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+        uint16_t field = 1 << i;
+        const field_schema_t& schema = field_schema[i];
+        if (!(present & field)) {
+            continue;
+        }
+        if (field == FIELD_LINK_HEALTH) {
+            for (uint8_t j = 0; j < FIELD_LINK_HEALTH_SIZE; j++) {
+                writer.write(frame.linkHealth[j], 8);
+            }
+        } else if ((keyframe != NULL) && (schema.deltaBits != 0) && (keyframe->present & field)) {
+            int32_t delta = (int32_t)frame.raw[i] - keyframe->raw[i];
+            int32_t limit = 1L << (schema.deltaBits - 1);
+            if ((delta < -limit) || (delta >= limit)) {
+                return 0;
+            }
+            writer.write((uint32_t)delta, schema.deltaBits);
+        } else {
+            writer.write(frame.raw[i], schema.bits);
+        }
+    }
+
+    for (uint8_t k = 0; (stats != NULL) && (k < STAT_COUNT); k++) {
+        for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+            if ((stats->fields[k] & present & ~FIELD_LINK_HEALTH) & (1 << i)) {
+                writer.write(stats->raw[k][i], field_schema[i].bits);
+            }
+        }
+    }
+
+    return writer.size();
+}
+
+/**
+ * @fn decodePayload
+ * @brief Decode the presence bitmap and fields of a frame, after its header (network
+ *        server side).
+ * @param[in] fields - fields bit mask of the frame (channel or history batch fields).
+ * @param[in] buf - frame, after the header.
+ * @param[in] size - frame size (in bytes), without the header.
+ * @param[in] keyframe - keyframe (raw values) of a delta frame, NULL otherwise.
+ * @param[out] frame - raw values (use \ref decodeField() to get the values).
+ * @param[in,out] stats - window statistics of a frame with \ref PAYLOAD_FLAG_STATS, with 
+ *                the channel statistics fields set (NULL = none).
+ * @return uint8_t - size (in bytes) decoded, 0 if the frame is too short.
+ */
+inline uint8_t decodePayload(uint16_t fields, const uint8_t* buf, uint8_t size, const payload_frame_t* keyframe, 
+                             payload_frame_t& frame, payload_stats_t* stats = NULL) {
+    BitReader reader(buf, size);
+    uint32_t raw = 0;
+
+    frame.present = 0;
+    for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+        if (fields & (1 << i)) {
+            if (!reader.read(raw, 1)) {
+                return 0;
+            }
+            frame.present |= raw << i;
+        }
+    }
+
+    for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+        uint16_t field = 1 << i;
+        const field_schema_t& schema = field_schema[i];
+        if (!(frame.present & field)) {
+            continue;
+        }
+        if (field == FIELD_LINK_HEALTH) {
+            for (uint8_t j = 0; j < FIELD_LINK_HEALTH_SIZE; j++) {
+                if (!reader.read(raw, 8)) {
+                    return 0;
+                }
+                frame.linkHealth[j] = raw;
+            }
+        } else if ((keyframe != NULL) && (schema.deltaBits != 0) && (keyframe->present & field)) {
+            if (!reader.read(raw, schema.deltaBits)) {
+                return 0;
+            }
+            // Sign extension of the difference
+            int32_t delta = (raw & (1UL << (schema.deltaBits - 1))) ? (int32_t)(raw | ~((1UL << schema.deltaBits) - 1)) : (int32_t)raw;
+            frame.raw[i] = keyframe->raw[i] + delta;
+        } else {
+            if (!reader.read(raw, schema.bits)) {
+                return 0;
+            }
+            frame.raw[i] = raw;
+        }
+    }
+
+    for (uint8_t k = 0; (stats != NULL) && (k < STAT_COUNT); k++) {
+        for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+            if ((stats->fields[k] & frame.present & ~FIELD_LINK_HEALTH) & (1 << i)) {
+                if (!reader.read(raw, field_schema[i].bits)) {
+                    return 0;
+                }
+                stats->raw[k][i] = raw;
+            }
+        }
+    }
+
+    return reader.size();
+}
+
+#endif // __PAYLOAD_CODEC_H__
@@ -0,0 +1,2046 @@
+/**
+ * @file RHF76.h
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief RHF76-052 LoRaWAN modem backend.
+ * @version alpha
+ * @since 09/01/2019
+ * @date 17/10/2026
+ * 
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>). 
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at 
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,  
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or 
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing 
+ * permissions and limitations under the License.
+ */
+#ifndef __RHF76_H__
+#define __RHF76_H__
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "LoRa.h"
+
+/**
+ * @class RHF76
+ * @brief RHF76 LoRaWAN modem backend (AT commands).
+ * @tparam Transport - modem UART (HardwareSerial or any class with begin(), end(), 
+ *         available(), read(), write(uint8_t) and print(const char*)).
+ * @tparam Log - logging policy (\ref LoRaSerialLog or \ref LoRaNoLog).
+ */
+template <class Transport, class Log>
+class RHF76 : public LoRaRadio<RHF76<Transport, Log>, Log> {
+    private:
+        Transport& transport;
+        bool loraBusy = false;
+        char rxLine[LORA_RX_BUFFER_SIZE];
+        uint8_t rxLineLen = 0;
+        char atResponse[LORA_RX_BUFFER_SIZE];
+        char atPrefix[LORA_AT_PREFIX_SIZE];
+        LoRaATState_e atState = LORA_AT_IDLE;
+        bool atUntilDone = false;
+        uint32_t atStart = 0;
+        uint16_t atTimeout = 0;
+        uint8_t atError = LORA_STATUS_OK;
+        uint8_t txBuffer[LORA_MAX_PAYLOAD_SIZE];
+        uint8_t txSize = 0;
+        bool txConfirmed = false;
+        bool txAcked = false;
+        uint8_t txAttempt = 0;
+        bool txRetryPending = false;
+        uint32_t txRetryStart = 0;
+        uint32_t txRetryDelay = 0;
+        void parseDownlink(const char* line);
+        bool joinAccepted = false;
+        char joinDevAddr[9];
+        uint8_t joinAttempt = 0;
+        uint32_t joinRetryStart = 0;
+        uint32_t joinRetryDelay = 0;
+        uint8_t fcntCount = 0;
+        bool fcntRunning = false;
+        bool drPending = false;
+        bool drRunning = false;
+        uint8_t restoreSession();
+        bool isSessionStored();
+        void saveSession(const char* devAddr);
+        void parseJoin(const char* line);
+        void checkJoin();
+        bool getFCnt(uint32_t& uplink, uint32_t& downlink);
+        bool parseFCnt(uint32_t& uplink, uint32_t& downlink);
+        uint8_t restoreFCnt();
+        void checkFCnt();
+        void checkDR();
+        bool tasksLocked = false;
+        bool modemSleeping = false;
+        bool sleepPending = false;
+        bool sleepRunning = false;
+        bool modemWaking = false;
+        bool wakeRunning = false;
+        uint8_t wakeAttempt = 0;
+        uint32_t wakeStart = 0;
+        void checkSleep();
+        bool isAwake();
+        void startWake();
+        void checkWake();
+        uint8_t linkCheckCount = 0;
+        void parseLinkStats(const char* text);
+        void requestLinkCheck();
+        void wakeModem();
+        void armATCmd(const char* cmd, uint16_t timeout, bool untilDone);
+        void processLine();
+        uint8_t execATCmd(const char* cmd, uint16_t timeout = LORA_CMD_TIMEOUT);
+        uint8_t getATStatus();
+        static uint8_t getLineError(const char* text);
+        uint8_t startTx(uint8_t statusCode, size_t size);
+        void checkTx();
+        void printATResponse(uint8_t statusCode);
+        uint8_t configureModule();
+        bool isConfigStored();
+        bool matchATQuery(const char* cmd, const char* value);
+        uint8_t setSerialInterface();                               
+        bool openUART(uint32_t baudrate);
+        bool recoverUART(uint32_t baudrate);
+        uint8_t setLoRaBaseBand();
+        String getLoRaBaseBandStr(LoRaBaseBand_e loraBaseBand);
+        uint8_t setLoRaSubBand();
+        uint8_t setLoRaClass();
+        String getLoRaClassStr(LoRaClass_e loraClass);
+        uint8_t setLoRaTxPwr();
+        String getLoRaTxPwrStr(LoRaTxPower_e loraTxPower);
+        uint8_t setLoRaUpDR();
+        String getLoRaUpDRStr(LoRaDR_e loraDR);
+        uint8_t setLoRaADR();
+        String getLoRaBoolStr(LoRaBool_e loraBool);
+        uint8_t setLoRaAuthMode();
+        String getLoRaAuthModeStr(LoRaAuthMode_e loraAuthMode);
+        uint8_t setLoRaDevEUI();
+        uint8_t setLoRaAppEUI();
+        uint8_t setLoRaDevAddr();
+        uint8_t setLoRaNwkSKey();
+        uint8_t setLoRaAppSKey();
+        uint8_t setLoRaAppKey();
+        uint8_t setLoRaPort(uint8_t port);
+        uint8_t beginATCmdHex(const char* cmd, const uint8_t* buf, size_t size, uint16_t timeout, bool untilDone);
+        void writeATCmdHex(const char* cmd, const uint8_t* buf, size_t size, uint16_t timeout, bool untilDone);
+        uint8_t setLoRaRetry();
+        uint8_t resetLoRaModule();
+
+    public:              
+        explicit RHF76(Transport& transport) : transport(transport) {}
+        uint8_t init(LoRaConfig_t config);
+        uint8_t beginATCmd(const char* cmd, uint16_t timeout = LORA_CMD_TIMEOUT, bool untilDone = false);
+        LoRaATState_e poll();
+        const char* getATResponse();
+        bool isBusy();
+        String getFWVersion(); 
+        uint8_t sendNoAckMsgHex(uint8_t port, String buf);
+        uint8_t sendNoAckMsgHex(uint8_t port, const uint8_t* buf, size_t size);
+        uint8_t sendAckMsgHex(uint8_t port, const uint8_t* buf, size_t size);
+};
+
+/*******************************************************
+ *             FUNCTIONS IMPLEMENTATIONS
+ *******************************************************/
+
+/**
+ * @fn RHF76::init(LoRaConfig_t config)
+ * @brief Initialize LoRa interface. 
+ * @details Modem keeps its configuration in flash, so the full configuration is only 
+ *          pushed when the fingerprint stored in EEPROM or the modem settings differ 
+ *          from \p config.
+ * @param[in] config - struct with LoRa configuration (see \ref LoRaConfig_t).
+ * @retval status code - 0 if successful initialization or error code.
+ */
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::init(LoRaConfig_t config) {
+    uint8_t statusCode = LORA_STATUS_UNINITIALIZED;
+    this->setConfig(config);
+
+    // Set serial interface
+    statusCode = setSerialInterface();
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    // Skip configuration if modem already holds it
+    if (isConfigStored()) {
+        if (Log::enabled) {
+            Log::print(F("\n\t\tModem configuration is up to date"));
+            Log::print(F("\n\t\tFirmware version: "));
+            Log::print(getFWVersion());
+            Log::flush();
+        }
+    } else {
+        // Invalidate fingerprint and session while modem is being configured
+        this->saveConfigRecord(false);
+
+        statusCode = configureModule();
+        if (statusCode != LORA_STATUS_OK) {
+            return statusCode;
+        }
+        this->saveConfigRecord(true);
+    }
+
+    statusCode = restoreSession();
+
+    // Modem sleeps until the first message
+    this->modemSleeping = false;
+    this->sleepPending = true;
+
+    return statusCode;
+}
+
+/**
+ * @fn RHF76::restoreSession()
+ * @brief Restore the LoRaWAN session after a reboot.
+ * @details OTAA session stored by the modem is reused if the DevAddr it reports is the 
+ *          one saved after the last join, otherwise a join is scheduled (see \ref poll()). 
+ *          Frame counters are restored from EEPROM, so the network does not drop the 
+ *          next uplinks.
+ * @retval status code - LORA_STATUS_OK.
+ */
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::restoreSession() {
+    this->joinAttempt = 0;
+    this->joinRetryDelay = 0;
+    this->joinRetryStart = millis();
+
+    if (this->config.auth_mode == LWOTAA) {
+        if (!isSessionStored()) {
+            this->joinStatus = LORA_NOT_JOINED;
+            return LORA_STATUS_OK;
+        }
+        if (Log::enabled) {
+            Log::print(F("\n\t\tLoRaWAN session restored"));
+            Log::flush();
+        }
+    }
+    this->joinStatus = LORA_JOINED;
+    restoreFCnt();
+
+    return LORA_STATUS_OK;
+}
+
+/**
+ * @fn RHF76::configureModule()
+ * @brief Reset the modem and push the whole LoRa configuration.
+ * @retval status code - 0 if successful configuration or error code.
+ */
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::configureModule() {
+    uint8_t statusCode = LORA_STATUS_UNINITIALIZED;
+
+    // Reset LoRa module
+    statusCode = resetLoRaModule();
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    delay(500);
+    
+    // Show firmware version
+    if (Log::enabled) {
+        Log::print(F("\n\t\tFirmware version: "));
+        Log::print(getFWVersion());
+        Log::flush();
+    }
+    
+    // Set LoRa base band
+    statusCode = setLoRaBaseBand();
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    // Set LoRa sub band
+    statusCode = setLoRaSubBand();
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    // Set LoRa class
+    statusCode = setLoRaClass();
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    // Set LoRa transmission power
+    statusCode = setLoRaTxPwr();
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    // Set LoRa ADR (Automatic Data Rate)
+    statusCode = setLoRaADR();
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    // Set LoRa uplink datarate
+    statusCode = setLoRaUpDR();
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    // Set LoRa DevEUI
+    statusCode = setLoRaDevEUI();
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    // Set LoRa authentication mode
+    statusCode = setLoRaAuthMode();
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    if (this->config.auth_mode == LWOTAA) {
+
+        // Set LoRa AppEUI
+        statusCode = setLoRaAppEUI();
+        if (statusCode != LORA_STATUS_OK) {
+            return statusCode;
+        }
+
+        // Set LoRa AppKey
+        statusCode = setLoRaAppKey();
+
+    } else {
+        
+        // Set LoRa DevAddr
+        statusCode = setLoRaDevAddr();
+
+        // Set LoRa NwkSKey
+        statusCode = setLoRaNwkSKey();
+
+        // Set LoRa AppSKey
+        statusCode = setLoRaAppSKey();
+
+    }
+
+    // Confirmed messages are retried by the driver (see \ref sendAckMsgHex())
+    if (statusCode == LORA_STATUS_OK) {
+        setLoRaRetry();
+    }
+
+    return statusCode;
+}
+
+/**
+ * @fn RHF76::isConfigStored()
+ * @brief Check if the modem already holds the configuration.
+ * @details Compare the fingerprint stored in EEPROM and query a few modem settings, 
+ *          so a replaced or factory reset modem is configured again.
+ * @retval true - modem configuration is up to date.
+ * @retval false - modem must be configured.
+ */
+template <class Transport, class Log>
+bool RHF76<Transport, Log>::isConfigStored() {
+    if (!this->isConfigSaved()) {
+        return false;
+    }
+
+    if (!matchATQuery("AT+MODE", getLoRaAuthModeStr(this->config.auth_mode).c_str()) ||
+        !matchATQuery("AT+CLASS", getLoRaClassStr(this->config.op_class).c_str()) ||
+        !matchATQuery("AT+ID=DevEui", this->config.dev_eui.c_str())) {
+        return false;
+    }
+
+    // DevAddr is assigned by the network in OTAA mode
+    if (this->config.auth_mode == LWOTAA) {
+        return matchATQuery("AT+ID=AppEui", this->config.app_eui.c_str());
+    }
+    return matchATQuery("AT+ID=DevAddr", this->config.dev_addr.c_str());
+}
+
+/**
+ * @fn RHF76::isSessionStored()
+ * @brief Check if the modem still holds the session of the last OTAA join.
+ * @retval true - session saved in EEPROM matches the configuration and modem DevAddr.
+ * @retval false - device must join the network.
+ */
+template <class Transport, class Log>
+bool RHF76<Transport, Log>::isSessionStored() {
+    LoRaSessionRecord_t session;
+    EEPROM.get(this->config.eeprom_addr + LORA_EEPROM_SESSION_OFFSET, session);
+    if ((session.magic != LORA_EEPROM_MAGIC) || (session.crc != this->getConfigCRC())) {
+        return false;
+    }
+    session.dev_addr[sizeof(session.dev_addr) - 1] = '\0';
+
+    return matchATQuery("AT+ID=DevAddr", session.dev_addr);
+}
+
+/**
+ * @fn RHF76::saveSession(const char* devAddr)
+ * @brief Save the session of a successful OTAA join and restart frame counters.
+ * @param[in] devAddr - DevAddr assigned by the network (8 hex digits).
+ */
+template <class Transport, class Log>
+void RHF76<Transport, Log>::saveSession(const char* devAddr) {
+    LoRaSessionRecord_t session;
+    memset(&session, 0, sizeof(session));
+    session.magic = LORA_EEPROM_MAGIC;
+    session.crc = this->getConfigCRC();
+    size_t size = strlen(devAddr);
+    if (size > (sizeof(session.dev_addr) - 1)) {
+        size = sizeof(session.dev_addr) - 1;
+    }
+    memcpy(session.dev_addr, devAddr, size);
+    session.dev_addr[size] = '\0';
+    EEPROM.put(this->config.eeprom_addr + LORA_EEPROM_SESSION_OFFSET, session);
+
+    // New session starts with frame counters at 0
+    this->saveFCnt(0, 0);
+    this->fcntCount = 0;
+}
+
+/**
+ * @fn RHF76::checkJoin()
+ * @brief Start the OTAA join when its backoff expires and handle the join result.
+ * @details Failed joins are retried with exponential backoff (from \ref LORA_JOIN_BACKOFF 
+ *          up to \ref LORA_JOIN_BACKOFF_MAX, plus jitter).
+ */
+template <class Transport, class Log>
+void RHF76<Transport, Log>::checkJoin() {
+    if (this->config.auth_mode != LWOTAA) {
+        return;
+    }
+
+    if (this->joinStatus == LORA_NOT_JOINED) {
+        if (!isBusy() && ((millis() - this->joinRetryStart) >= this->joinRetryDelay)) {
+            if (Log::enabled && !this->modemSleeping) {
+                Log::print(F("\n\tJoining LoRaWAN network... "));
+                Log::flush();
+            }
+            this->joinAccepted = false;
+            this->joinDevAddr[0] = '\0';
+            if (isAwake() && (beginATCmd("AT+JOIN", LORA_JOIN_TIMEOUT, true) == LORA_STATUS_OK)) {
+                this->joinStatus = LORA_JOINING;
+            }
+        }
+    } else if ((this->joinStatus == LORA_JOINING) && (this->atState != LORA_AT_WAITING)) {
+        if ((this->atState == LORA_AT_DONE) && this->joinAccepted) {
+            this->joinStatus = LORA_JOINED;
+            this->joinAttempt = 0;
+            saveSession(this->joinDevAddr);
+        } else {
+            uint32_t backoff = (uint32_t)LORA_JOIN_BACKOFF << this->joinAttempt;
+            if (backoff >= LORA_JOIN_BACKOFF_MAX) {
+                backoff = LORA_JOIN_BACKOFF_MAX;
+            } else {
+                this->joinAttempt++;
+            }
+            this->joinStatus = LORA_NOT_JOINED;
+            this->joinRetryDelay = backoff + random(LORA_JOIN_BACKOFF);
+            this->joinRetryStart = millis();
+        }
+        if (Log::enabled) {
+            Log::print((this->joinStatus == LORA_JOINED) ? F("\n\tJoin [OK]") : F("\n\tJoin [FAIL]"));
+            Log::flush();
+        }
+        this->sleepPending = true;
+    }
+}
+
+/**
+ * @fn RHF76::getFCnt(uint32_t& uplink, uint32_t& downlink)
+ * @brief Query modem frame counters (+LW: ULDL, <uplink>, <downlink>).
+ * @retval true - counters read.
+ * @retval false - modem did not answer the counters.
+ */
+template <class Transport, class Log>
+bool RHF76<Transport, Log>::getFCnt(uint32_t& uplink, uint32_t& downlink) {
+    return (execATCmd("AT+LW=ULDL") == LORA_STATUS_OK) && parseFCnt(uplink, downlink);
+}
+
+/**
+ * @fn RHF76::parseFCnt(uint32_t& uplink, uint32_t& downlink)
+ * @brief Read frame counters from the response of "AT+LW=ULDL".
+ * @retval true - counters read.
+ * @retval false - response does not hold the counters.
+ */
+template <class Transport, class Log>
+bool RHF76<Transport, Log>::parseFCnt(uint32_t& uplink, uint32_t& downlink) {
+    const char* counters = strstr(this->atResponse, "ULDL, ");
+    if (counters == NULL) {
+        return false;
+    }
+    char* next = NULL;
+    uplink = strtoul(counters + 6, &next, 10);
+    if ((next == NULL) || (*next != ',')) {
+        return false;
+    }
+    downlink = strtoul(next + 1, NULL, 10);
+
+    return true;
+}
+
+/**
+ * @fn RHF76::restoreFCnt()
+ * @brief Restore frame counters saved in EEPROM.
+ * @details Counters are saved every \ref LORA_FCNT_SAVE_INTERVAL messages, so the uplink 
+ *          counter is restored that far ahead and saved again at once. Modem counters 
+ *          are never moved backwards (e.g. when only the MCU was reset).
+ * @retval status code - LORA_STATUS_OK or error code.
+ */
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::restoreFCnt() {
+    uint8_t statusCode = LORA_STATUS_OK;
+    LoRaFCntRecord_t record;
+    uint32_t uplink = 0;
+    uint32_t downlink = 0;
+    char at_cmd[40] = "AT+LW=ULDL, ";
+
+    if ((this->loadFCnt(record) < 0) || !getFCnt(uplink, downlink)) {
+        return LORA_STATUS_OK;
+    }
+    record.uplink += LORA_FCNT_SAVE_INTERVAL;
+    if ((uplink >= record.uplink) && (downlink >= record.downlink)) {
+        return LORA_STATUS_OK;
+    }
+
+    if (Log::enabled) {
+        Log::print(F("\n\t\tRestoring LoRa frame counters... "));
+        Log::flush();
+    }
+    if (uplink < record.uplink) {
+        uplink = record.uplink;
+    }
+    if (downlink < record.downlink) {
+        downlink = record.downlink;
+    }
+    ultoa(uplink, at_cmd + strlen(at_cmd), 10);
+    strcat(at_cmd, ", ");
+    ultoa(downlink, at_cmd + strlen(at_cmd), 10);
+    statusCode = execATCmd(at_cmd);
+    printATResponse(statusCode);
+
+    // Message count restarts at 0 on every boot, so save now: a node reset more often
+    // than every LORA_FCNT_SAVE_INTERVAL messages would restore the same counters again
+    if (statusCode == LORA_STATUS_OK) {
+        this->saveFCnt(uplink, downlink);
+    }
+
+    return statusCode;
+}
+
+/**
+ * @fn RHF76::checkFCnt()
+ * @brief Save frame counters every \ref LORA_FCNT_SAVE_INTERVAL messages: start the 
+ *        query when the modem is idle and save its answer once received. Never blocks.
+ */
+template <class Transport, class Log>
+void RHF76<Transport, Log>::checkFCnt() {
+    uint32_t uplink = 0;
+    uint32_t downlink = 0;
+
+    if (this->fcntRunning) {
+        if (this->atState != LORA_AT_WAITING) {
+            if ((this->atState == LORA_AT_DONE) && parseFCnt(uplink, downlink)) {
+                this->saveFCnt(uplink, downlink);
+            }
+            this->fcntRunning = false;
+            this->atState = LORA_AT_IDLE;
+        }
+    } else if ((this->fcntCount >= LORA_FCNT_SAVE_INTERVAL) && !isBusy() && (this->joinStatus == LORA_JOINED)) {
+        if (isAwake() && (beginATCmd("AT+LW=ULDL") == LORA_STATUS_OK)) {
+            this->fcntCount = 0;
+            this->fcntRunning = true;
+        }
+    }
+}
+
+/**
+ * @fn RHF76::checkDR()
+ * @brief Read the uplink datarate after a transmission when ADR is enabled, since 
+ *        the network may have changed it (+DR: DR<n>). Never blocks.
+ */
+template <class Transport, class Log>
+void RHF76<Transport, Log>::checkDR() {
+    if (this->drRunning) {
+        if (this->atState != LORA_AT_WAITING) {
+            const char* dr = strstr(this->atResponse, " DR");
+            if ((this->atState == LORA_AT_DONE) && (dr != NULL) && isdigit(dr[3])) {
+                this->currentDR = (LoRaDR_e)atoi(dr + 3);
+            }
+            this->drRunning = false;
+            this->atState = LORA_AT_IDLE;
+        }
+    } else if (this->drPending && !isBusy() && (this->joinStatus == LORA_JOINED)) {
+        if (isAwake() && (beginATCmd("AT+DR") == LORA_STATUS_OK)) {
+            this->drPending = false;
+            this->drRunning = true;
+        }
+    }
+}
+
+/**
+ * @fn RHF76::matchATQuery(const char* cmd, const char* value)
+ * @brief Send a query command and compare the value answered by the modem.
+ * @details Value is the text after ", " (or ": ") of the response line; separators 
+ *          ':' are ignored and comparison is case insensitive, so "+ID: DevAddr, 26:01:1B:4C" 
+ *          matches "26011b4c".
+ * @param[in] cmd - AT query command.
+ * @param[in] value - expected value.
+ * @retval true - modem answered the expected value.
+ * @retval false - modem answered a different value or did not answer.
+ */
+template <class Transport, class Log>
+bool RHF76<Transport, Log>::matchATQuery(const char* cmd, const char* value) {
+    if (execATCmd(cmd) != LORA_STATUS_OK) {
+        return false;
+    }
+
+    const char* answer = strstr(this->atResponse, ", ");
+    if (answer == NULL) {
+        answer = strstr(this->atResponse, ": ");
+        if (answer == NULL) {
+            return false;
+        }
+    }
+    answer += 2;
+
+    while ((*answer != '\0') && (*value != '\0')) {
+        if (*answer == ':') {
+            answer++;
+            continue;
+        }
+        if (toupper(*answer) != toupper(*value)) {
+            return false;
+        }
+        answer++;
+        value++;
+    }
+
+    return (*answer == '\0') && (*value == '\0');
+}
+
+/**
+ * @fn RHF76::beginATCmd(const char* cmd, uint16_t timeout, bool untilDone)
+ * @brief Send an AT command to the modem without waiting for its response.
+ * @details The transaction ends when the modem sends the response line of the 
+ *          command (or its "Done" line, if \p untilDone is set), or when the 
+ *          deadline expires. Call \ref poll() to progress it.
+ * @param[in] cmd - AT command (without line terminator).
+ * @param[in] timeout - command deadline (in ms).
+ * @param[in] untilDone - wait for the "Done" line instead of the first response line.
+ * @retval LORA_STATUS_OK - command sent.
+ * @retval LORA_STATUS_BUSY - another AT transaction is still in progress.
+ */
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::beginATCmd(const char* cmd, uint16_t timeout, bool untilDone) {
+    if (poll() == LORA_AT_WAITING) {
+        return LORA_STATUS_BUSY;
+    }
+    wakeModem();
+
+    armATCmd(cmd, timeout, untilDone);
+    this->transport.print(cmd);
+    this->transport.print("\r\n");
+
+    return LORA_STATUS_OK;
+}
+
+/**
+ * @fn RHF76::armATCmd(const char* cmd, uint16_t timeout, bool untilDone)
+ * @brief Prepare the AT transaction state for a command about to be sent.
+ * @details Response prefix is derived from the command name, so "AT+DR=DR1" 
+ *          expects a "+DR:" line and "AT" expects a "+AT:" line.
+ */
+template <class Transport, class Log>
+void RHF76<Transport, Log>::armATCmd(const char* cmd, uint16_t timeout, bool untilDone) {
+    uint8_t i = 1;
+
+    // Skip "AT+" (or "AT" for the test command)
+    cmd += (strncmp(cmd, "AT+", 3) == 0) ? 3 : 0;
+    this->atPrefix[0] = '+';
+    while ((*cmd != '\0') && (*cmd != '=') && (i < (LORA_AT_PREFIX_SIZE - 2))) {
+        this->atPrefix[i++] = *cmd++;
+    }
+    this->atPrefix[i++] = ':';
+    this->atPrefix[i] = '\0';
+
+    this->atResponse[0] = '\0';
+    this->atUntilDone = untilDone;
+    this->atTimeout = timeout;
+    this->atStart = millis();
+    this->atState = LORA_AT_WAITING;
+    this->loraBusy = true;
+}
+
+/**
+ * @fn RHF76::poll()
+ * @brief Process bytes received from the modem and run the background tasks (downlink 
+ *        handlers, transmission result, join, frame counters, ADR datarate and low 
+ *        power), which start AT commands and collect their answers on later calls. 
+ *        Never blocks, so it can be called on every loop() iteration.
+ * @return LoRaATState_e - state of the current AT transaction.
+ */
+template <class Transport, class Log>
+LoRaATState_e RHF76<Transport, Log>::poll() {
+    while (this->transport.available()) {
+        char c = (char)this->transport.read();
+        if (c == '\n') {
+            this->rxLine[this->rxLineLen] = '\0';
+            processLine();
+            this->rxLineLen = 0;
+        } else if ((c != '\r') && (this->rxLineLen < (LORA_RX_BUFFER_SIZE - 1))) {
+            this->rxLine[this->rxLineLen++] = c;
+        }
+    }
+
+    if ((this->atState == LORA_AT_WAITING) && ((millis() - this->atStart) >= this->atTimeout)) {
+        this->atState = LORA_AT_TIMEOUT;
+        this->loraBusy = false;
+    }
+
+    // Background tasks may send AT commands, so they never run nested in another 
+    // task or in a blocking command
+    if (!this->tasksLocked) {
+        this->tasksLocked = true;
+        this->callback_RX();
+        checkTx();
+        checkWake();
+        checkJoin();
+        checkFCnt();
+        checkDR();
+        checkSleep();
+        this->tasksLocked = false;
+    }
+
+    return this->atState;
+}
+
+/**
+ * @fn RHF76::checkTx()
+ * @brief Progress the pending transmission: retry unacknowledged confirmed messages 
+ *        and report the end of the transmission.
+ */
+template <class Transport, class Log>
+void RHF76<Transport, Log>::checkTx() {
+    if (this->txStatus != LORA_TX_PENDING) {
+        return;
+    }
+
+    // Confirmed message waiting for its retry backoff
+    if (this->txRetryPending) {
+        if ((millis() - this->txRetryStart) >= this->txRetryDelay) {
+            this->txRetryPending = false;
+            this->txAcked = false;
+            this->spendAirtime(this->txSize);
+            writeATCmdHex("AT+CMSGHEX", this->txBuffer, this->txSize, LORA_TX_TIMEOUT, true);
+        }
+        return;
+    }
+
+    if (this->atState == LORA_AT_WAITING) {
+        return;
+    }
+
+    uint8_t statusCode = getATStatus();
+    if (this->txConfirmed && (statusCode == LORA_STATUS_OK) && !this->txAcked) {
+        statusCode = LORA_STATUS_NO_ACK;
+    }
+    this->fcntCount++;
+
+    // Modem lost the OTAA session, so join again
+    if ((statusCode == LORA_STATUS_NOT_JOINED) && (this->config.auth_mode == LWOTAA)) {
+        this->joinStatus = LORA_NOT_JOINED;
+        this->joinRetryDelay = 0;
+        this->joinRetryStart = millis();
+    }
+
+    // Retry confirmed message with exponential backoff (plus jitter)
+    if (this->txConfirmed && (statusCode != LORA_STATUS_OK) && (this->txAttempt < this->config.retry)) {
+        this->txRetryDelay = ((uint32_t)this->config.retry_backoff << this->txAttempt) + random(this->config.retry_backoff + 1);
+        this->txAttempt++;
+        this->txRetryStart = millis();
+        this->txRetryPending = true;
+        if (Log::enabled) {
+            Log::print(F("\n\tACK not received, retrying in "));
+            Log::print(this->txRetryDelay);
+            Log::print(F(" ms"));
+            Log::flush();
+        }
+        return;
+    }
+
+    // Report the end of the transmission
+    this->sleepPending = true;
+    this->drPending = (this->config.adr == ON);
+    this->endTx(statusCode);
+}
+
+/**
+ * @fn RHF76::checkSleep()
+ * @brief Put the modem in low power mode once it is idle after a transmission 
+ *        (only class A devices with \ref LoRaConfig_t::low_power enabled). Never blocks.
+ */
+template <class Transport, class Log>
+void RHF76<Transport, Log>::checkSleep() {
+    if (this->sleepRunning) {
+        if (this->atState != LORA_AT_WAITING) {
+            uint8_t statusCode = getATStatus();
+            printATResponse(statusCode);
+            this->modemSleeping = (statusCode == LORA_STATUS_OK);
+            this->sleepRunning = false;
+            this->atState = LORA_AT_IDLE;
+        }
+        return;
+    }
+
+    if (!this->sleepPending || isBusy() || (this->joinStatus == LORA_JOINING)) {
+        return;
+    }
+    this->sleepPending = false;
+    if (!this->config.low_power || (this->config.op_class != A) || this->modemSleeping) {
+        return;
+    }
+
+    if (Log::enabled) {
+        Log::print(F("\n\tPutting LoRa modem in low power mode... "));
+        Log::flush();
+    }
+    if (beginATCmd("AT+LOWPOWER") == LORA_STATUS_OK) {
+        this->sleepRunning = true;
+    }
+}
+
+/**
+ * @fn RHF76::isAwake()
+ * @brief Check if a background task may send a command, starting the wake up of a 
+ *        sleeping modem otherwise (see \ref checkWake()).
+ * @retval true - modem is awake.
+ * @retval false - modem is waking up, the task must try again later.
+ */
+template <class Transport, class Log>
+bool RHF76<Transport, Log>::isAwake() {
+    if (!this->modemSleeping) {
+        return true;
+    }
+    if (!this->modemWaking) {
+        startWake();
+    }
+
+    return false;
+}
+
+/**
+ * @fn RHF76::startWake()
+ * @brief Send the wake up preamble to the modem.
+ * @details Any character wakes the modem up, but the characters received while it 
+ *          wakes up are lost, so a preamble of 0xFF bytes (ignored by the AT parser) 
+ *          is sent and the modem is only probed \ref LORA_WAKE_DELAY later.
+ */
+template <class Transport, class Log>
+void RHF76<Transport, Log>::startWake() {
+    for (uint8_t i = 0; i < LORA_WAKE_PREAMBLE_SIZE; i++) {
+        this->transport.write((uint8_t)0xFF);
+    }
+    this->transport.print("\r\n");
+    this->wakeStart = millis();
+    this->wakeAttempt = 0;
+    this->modemWaking = true;
+}
+
+/**
+ * @fn RHF76::checkWake()
+ * @brief Probe the modem woken up by \ref isAwake() once \ref LORA_WAKE_DELAY has 
+ *        passed, up to \ref LORA_WAKE_RETRY times. Never blocks.
+ */
+template <class Transport, class Log>
+void RHF76<Transport, Log>::checkWake() {
+    if (this->wakeRunning) {
+        if (this->atState == LORA_AT_WAITING) {
+            return;
+        }
+        bool awake = (this->atState == LORA_AT_DONE);
+        this->wakeRunning = false;
+        this->atState = LORA_AT_IDLE;
+        if (awake || (++this->wakeAttempt >= LORA_WAKE_RETRY)) {
+            this->modemSleeping = false;
+            this->modemWaking = false;
+            if (!awake && Log::enabled) {
+                Log::print(F("\n\tLoRa modem did not wake up"));
+                Log::flush();
+            }
+        }
+        return;
+    }
+
+    if (this->modemWaking && !this->loraBusy && ((millis() - this->wakeStart) >= LORA_WAKE_DELAY)) {
+        armATCmd("AT", LORA_CMD_TIMEOUT, false);
+        this->transport.print("AT\r\n");
+        this->wakeRunning = true;
+    }
+}
+
+/**
+ * @fn RHF76::wakeModem()
+ * @brief Wake the modem up from low power mode before a command is sent, waiting 
+ *        until it answers (see \ref startWake()).
+ * @details Only used by commands sent by the application, background tasks of 
+ *          \ref poll() wake the modem up with \ref isAwake().
+ */
+template <class Transport, class Log>
+void RHF76<Transport, Log>::wakeModem() {
+    if (!this->modemSleeping) {
+        return;
+    }
+    if (!this->modemWaking) {
+        startWake();
+    }
+    this->modemSleeping = false;
+    this->modemWaking = false;
+    this->wakeRunning = false;
+
+    uint32_t elapsed = millis() - this->wakeStart;
+    if (elapsed < LORA_WAKE_DELAY) {
+        delay(LORA_WAKE_DELAY - elapsed);
+    }
+
+    for (uint8_t i = 0; i < LORA_WAKE_RETRY; i++) {
+        if (execATCmd("AT") == LORA_STATUS_OK) {
+            return;
+        }
+    }
+    if (Log::enabled) {
+        Log::print(F("\n\tLoRa modem did not wake up"));
+        Log::flush();
+    }
+}
+
+/**
+ * @fn RHF76::processLine()
+ * @brief Handle a complete line received from the modem.
+ */
+template <class Transport, class Log>
+void RHF76<Transport, Log>::processLine() {
+    if (this->rxLineLen == 0) {
+        return;
+    }
+
+    // Downlink (answered inside a transmission or unsolicited in class C)
+    if (strstr(this->rxLine, "RX: \"") != NULL) {
+        parseDownlink(this->rxLine);
+    }
+
+    // Response of the AT transaction in progress
+    if ((this->atState == LORA_AT_WAITING) && 
+        (strncmp(this->rxLine, this->atPrefix, strlen(this->atPrefix)) == 0)) {
+        strcpy(this->atResponse, this->rxLine);
+        if (strstr(this->rxLine, "ACK Received") != NULL) {
+            this->txAcked = true;
+        }
+        if (this->joinStatus == LORA_JOINING) {
+            parseJoin(this->rxLine);
+        }
+        if (this->txStatus == LORA_TX_PENDING) {
+            parseLinkStats(this->rxLine + strlen(this->atPrefix));
+        }
+        this->atError = getLineError(this->rxLine + strlen(this->atPrefix));
+        if (this->atError != LORA_STATUS_OK) {
+            this->atState = LORA_AT_ERROR;
+        } else if (!this->atUntilDone || (strstr(this->rxLine, "Done") != NULL)) {
+            this->atState = LORA_AT_DONE;
+        }
+        if (this->atState != LORA_AT_WAITING) {
+            this->loraBusy = false;
+        }
+        return;
+    }
+
+    // Unsolicited line
+    if (Log::enabled) {
+        Log::print(F("\n\t\t"));
+        Log::print(this->rxLine);
+        Log::flush();
+    }
+}
+
+/**
+ * @fn RHF76::parseLinkStats(const char* text)
+ * @brief Collect link statistics of the transmission in progress from its lines 
+ *        ("RXWIN1, RSSI -106, SNR 4.0" and link check answer "Link 20, 1").
+ * @details SNR is kept in whole dB, so no floating point parsing is needed.
+ * @param[in] text - line text after the response prefix.
+ */
+template <class Transport, class Log>
+void RHF76<Transport, Log>::parseLinkStats(const char* text) {
+    const char* field = strstr(text, "RSSI ");
+    if (field != NULL) {
+        this->linkCurrent.rssi = strtol(field + 5, NULL, 10);
+        this->linkCurrent.flags |= LORA_LINK_RSSI;
+    }
+
+    field = strstr(text, "SNR ");
+    if (field != NULL) {
+        this->linkCurrent.snr = strtol(field + 4, NULL, 10);
+    }
+
+    field = strstr(text, "Link ");
+    if (field != NULL) {
+        char* next = NULL;
+        this->linkCurrent.margin = strtoul(field + 5, &next, 10);
+        if ((next != NULL) && (*next == ',')) {
+            this->linkCurrent.gateways = strtoul(next + 1, NULL, 10);
+            this->linkCurrent.flags |= LORA_LINK_CHECK;
+        }
+    }
+}
+
+/**
+ * @fn RHF76::requestLinkCheck()
+ * @brief Piggyback a LinkCheckReq on one of every \ref LoRaConfig_t::link_check_every 
+ *        messages, so the network reports link margin and gateway count.
+ * @details Its answer is a downlink, so it waits while the downlink budget is spent.
+ *          Only called by the send functions, before the message command: like
+ *          \ref setLoRaPort(), it waits for the modem to queue the request (a local
+ *          command, answered at once), so \ref poll() never runs it.
+ */
+template <class Transport, class Log>
+void RHF76<Transport, Log>::requestLinkCheck() {
+    if ((this->config.link_check_every == 0) || (++this->linkCheckCount < this->config.link_check_every) || 
+        !this->isDownlinkAvailable()) {
+        return;
+    }
+    this->linkCheckCount = 0;
+
+    if (Log::enabled) {
+        Log::print(F("\n\tRequesting link check... "));
+        Log::flush();
+    }
+    uint8_t statusCode = execATCmd("AT+LW=LCR");
+    printATResponse(statusCode);
+    if (statusCode == LORA_STATUS_OK) {
+        this->spendDownlink();
+    }
+}
+
+/**
+ * @fn RHF76::parseDownlink(const char* line)
+ * @brief Decode a downlink line (e.g. +MSG: PORT: 2; RX: "0A1B") and keep it to be 
+ *        dispatched by \ref callback_RX().
+ * @param[in] line - modem line.
+ */
+template <class Transport, class Log>
+void RHF76<Transport, Log>::parseDownlink(const char* line) {
+    const char* port = strstr(line, "PORT: ");
+    const char* data = strstr(line, "RX: \"");
+    if ((port == NULL) || (data == NULL)) {
+        return;
+    }
+
+    this->rxPort = (uint8_t)atoi(port + 6);
+    this->rxSize = 0;
+    data += 5;
+    while (isxdigit(data[0]) && isxdigit(data[1]) && (this->rxSize < LORA_MAX_PAYLOAD_SIZE)) {
+        char hexByte[3] = {data[0], data[1], '\0'};
+        this->rxBuffer[this->rxSize++] = (uint8_t)strtoul(hexByte, NULL, 16);
+        data += 2;
+    }
+    this->rxPending = true;
+}
+
+/**
+ * @fn RHF76::parseJoin(const char* line)
+ * @brief Handle a line of the join procedure ("Network joined", "Joined already" and 
+ *        "NetID 000013 DevAddr 26:01:5F:66").
+ * @param[in] line - modem line.
+ */
+template <class Transport, class Log>
+void RHF76<Transport, Log>::parseJoin(const char* line) {
+    if ((strstr(line, "Network joined") != NULL) || (strstr(line, "Joined already") != NULL)) {
+        this->joinAccepted = true;
+    }
+
+    const char* devAddr = strstr(line, "DevAddr ");
+    if (devAddr != NULL) {
+        uint8_t i = 0;
+        for (devAddr += 8; (*devAddr != '\0') && (i < 8); devAddr++) {
+            if (isxdigit(*devAddr)) {
+                this->joinDevAddr[i++] = *devAddr;
+            }
+        }
+        this->joinDevAddr[i] = '\0';
+    }
+}
+
+/**
+ * @fn RHF76::getLineError(const char* text)
+ * @brief Classify the text of a response line (after its "+CMD:" prefix).
+ * @details Besides "ERROR(-n)", transmission commands answer a few textual failures 
+ *          (e.g. "No band in 1234ms", "Please join network first") without a "Done" line.
+ * @param[in] text - response text.
+ * @retval LORA_STATUS_OK - line is not an error.
+ * @retval error code - status code matching the failure.
+ */
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::getLineError(const char* text) {
+    if (strstr(text, "ERROR") != NULL) {
+        return LORA_STATUS_AT_ERROR;
+    } else if ((strstr(text, "No band") != NULL) || (strstr(text, "No free channel") != NULL)) {
+        return LORA_STATUS_NO_BAND;
+    } else if (strstr(text, "Please join") != NULL) {
+        return LORA_STATUS_NOT_JOINED;
+    } else if (strstr(text, "busy") != NULL) {
+        return LORA_STATUS_BUSY;
+    } else if (strstr(text, "error") != NULL) {
+        return LORA_STATUS_AT_ERROR;
+    }
+
+    return LORA_STATUS_OK;
+}
+
+/**
+ * @fn RHF76::isBusy()
+ * @brief Check if the modem is processing an AT command or a transmission.
+ */
+template <class Transport, class Log>
+bool RHF76<Transport, Log>::isBusy() {
+    return this->loraBusy || (this->txStatus == LORA_TX_PENDING);
+}
+
+/**
+ * @fn RHF76::startTx(uint8_t statusCode, size_t size)
+ * @brief Mark a transmission as pending if its AT command was sent.
+ * @param[in] statusCode - status of the transmission command.
+ * @param[in] size - message size (in bytes).
+ * @return uint8_t - same \p statusCode.
+ */
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::startTx(uint8_t statusCode, size_t size) {
+    if (statusCode == LORA_STATUS_OK) {
+        this->beginTx(size, this->txConfirmed);
+        this->txAcked = false;
+        this->txAttempt = 0;
+        this->txRetryPending = false;
+    }
+
+    return statusCode;
+}
+
+/**
+ * @fn RHF76::execATCmd(const char* cmd, uint16_t timeout)
+ * @brief Send an AT command and wait for its response line (or deadline).
+ * @param[in] cmd - AT command (without line terminator).
+ * @param[in] timeout - command deadline (in ms).
+ * @retval status code - LORA_STATUS_OK or error code.
+ */
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::execATCmd(const char* cmd, uint16_t timeout) {
+    bool tasksLocked = this->tasksLocked;
+
+    // Background tasks must not start commands while waiting for this one
+    this->tasksLocked = true;
+    uint8_t statusCode = beginATCmd(cmd, timeout);
+    if (statusCode == LORA_STATUS_OK) {
+        while (poll() == LORA_AT_WAITING) {;}
+        statusCode = getATStatus();
+    }
+    this->tasksLocked = tasksLocked;
+
+    return statusCode;
+}
+
+/**
+ * @fn RHF76::getATStatus()
+ * @brief Convert the AT transaction state to a status code.
+ */
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::getATStatus() {
+    switch (this->atState) {
+        case LORA_AT_DONE:
+            return LORA_STATUS_OK;
+        case LORA_AT_ERROR:
+            return this->atError;
+        case LORA_AT_TIMEOUT:
+            return LORA_STATUS_TIMEOUT;
+        case LORA_AT_WAITING:
+            return LORA_STATUS_BUSY;
+        default:
+            return LORA_STATUS_UNINITIALIZED;
+    }
+}
+
+/**
+ * @fn RHF76::getATResponse()
+ * @brief Get the last response line of the modem (without line terminator).
+ */
+template <class Transport, class Log>
+const char* RHF76<Transport, Log>::getATResponse() {
+    return this->atResponse;
+}
+
+/**
+ * @fn RHF76::printATResponse(uint8_t statusCode)
+ * @brief Print the response of the last AT command on debug serial.
+ */
+template <class Transport, class Log>
+void RHF76<Transport, Log>::printATResponse(uint8_t statusCode) {
+    if (Log::enabled) {
+        if (statusCode == LORA_STATUS_TIMEOUT) {
+            Log::print(F("[TIMEOUT]"));
+        } else {
+            Log::print(this->atResponse);
+        }
+        Log::flush();
+    }
+}
+
+/**
+ * @fn RHF76::setSerialInterface()
+ * @brief Open the UART to the modem at \ref LoRaConfig_t::uart_baudrate.
+ * @details Modem keeps its baud rate across resets, so the configured rate is probed 
+ *          first. Otherwise the modem is reached at its default rate 
+ *          (\ref LORA_UART_DEFAULT_BAUDRATE) and switched with AT+UART=BR. If the 
+ *          modem does not answer at either rate afterwards (e.g. the reset answer was 
+ *          lost or an older configuration switched it), it is searched at every 
+ *          supported rate (see \ref recoverUART()).
+ * @retval status code - LORA_STATUS_OK or LORA_STATUS_UART_FAIL.
+ */
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::setSerialInterface() {
+    uint32_t baudrate = this->config.uart_baudrate;
+    char at_cmd[24] = "AT+UART=BR, ";
+
+    if (baudrate == 0) {
+        baudrate = LORA_UART_DEFAULT_BAUDRATE;
+    }
+
+    // Configure UART communication between MCU and LoRaWAN modem
+    if (Log::enabled) {
+        Log::print(F("\n\t\tInitiating UART port between MCU device and LoRa modem... "));
+        Log::print(baudrate);
+        Log::print(F(" bps "));
+        Log::flush();
+    }
+    if (openUART(baudrate)) {
+        return LORA_STATUS_OK;
+    }
+
+    // Reach modem at its default baud rate
+    if (baudrate != LORA_UART_DEFAULT_BAUDRATE) {
+        if (Log::enabled) {
+            Log::print(F("\n\t\tInitiating UART port between MCU device and LoRa modem... "));
+            Log::print(LORA_UART_DEFAULT_BAUDRATE);
+            Log::print(F(" bps "));
+            Log::flush();
+        }
+        if (openUART(LORA_UART_DEFAULT_BAUDRATE)) {
+            // Switch modem baud rate (applied after reset)
+            if (Log::enabled) {
+                Log::print(F("\n\t\tSetting LoRa modem baud rate... "));
+                Log::flush();
+            }
+            ultoa(baudrate, at_cmd + strlen(at_cmd), 10);
+            uint8_t statusCode = execATCmd(at_cmd);
+            printATResponse(statusCode);
+            if ((statusCode == LORA_STATUS_OK) && (resetLoRaModule() == LORA_STATUS_OK)) {
+                delay(500);
+                if (Log::enabled) {
+                    Log::print(F("\n\t\tInitiating UART port between MCU device and LoRa modem... "));
+                    Log::print(baudrate);
+                    Log::print(F(" bps "));
+                    Log::flush();
+                }
+                if (openUART(baudrate)) {
+                    return LORA_STATUS_OK;
+                }
+            }
+        }
+    }
+
+    // Modem baud rate is unknown
+    return recoverUART(baudrate) ? LORA_STATUS_OK : LORA_STATUS_UART_FAIL;
+}
+
+/**
+ * @fn RHF76::recoverUART(uint32_t baudrate)
+ * @brief Search the modem at every baud rate supported by AT+UART=BR.
+ * @details A modem found at a rate other than \p baudrate is switched back to 
+ *          \ref LORA_UART_DEFAULT_BAUDRATE, so the next initialization reaches it again.
+ * @param[in] baudrate - configured baud rate (kept if the modem answers at it).
+ * @retval true - modem answered (UART left open at the rate it answered).
+ * @retval false - modem did not answer at any rate.
+ */
+template <class Transport, class Log>
+bool RHF76<Transport, Log>::recoverUART(uint32_t baudrate) {
+    static const uint32_t BAUDRATES[] = {9600, 14400, 19200, 38400, 57600, 76800, 115200, 230400};
+    char at_cmd[24] = "AT+UART=BR, ";
+
+    for (uint8_t i = 0; i < (sizeof(BAUDRATES) / sizeof(BAUDRATES[0])); i++) {
+        if (Log::enabled) {
+            Log::print(F("\n\t\tProbing LoRa modem UART... "));
+            Log::print(BAUDRATES[i]);
+            Log::print(F(" bps "));
+            Log::flush();
+        }
+        if (!openUART(BAUDRATES[i])) {
+            continue;
+        }
+        if ((BAUDRATES[i] == baudrate) || (BAUDRATES[i] == LORA_UART_DEFAULT_BAUDRATE)) {
+            return true;
+        }
+
+        // Restore modem default baud rate (applied after reset)
+        if (Log::enabled) {
+            Log::print(F("\n\t\tRestoring LoRa modem default baud rate... "));
+            Log::flush();
+        }
+        ultoa(LORA_UART_DEFAULT_BAUDRATE, at_cmd + strlen(at_cmd), 10);
+        uint8_t statusCode = execATCmd(at_cmd);
+        printATResponse(statusCode);
+        if (statusCode != LORA_STATUS_OK) {
+            // Modem still answers at the rate it was found
+            return true;
+        }
+        resetLoRaModule();
+        delay(500);
+        if (Log::enabled) {
+            Log::print(F("\n\t\tInitiating UART port between MCU device and LoRa modem... "));
+            Log::print(LORA_UART_DEFAULT_BAUDRATE);
+            Log::print(F(" bps "));
+            Log::flush();
+        }
+        return openUART(LORA_UART_DEFAULT_BAUDRATE);
+    }
+
+    return false;
+}
+
+/**
+ * @fn RHF76::openUART(uint32_t baudrate)
+ * @brief Open the modem UART and check if the modem answers.
+ * @param[in] baudrate - UART baud rate (in bps).
+ * @retval true - modem answered "+AT: OK".
+ * @retval false - no valid answer.
+ */
+template <class Transport, class Log>
+bool RHF76<Transport, Log>::openUART(uint32_t baudrate) {
+    uint8_t statusCode = LORA_STATUS_OK;
+
+    // Initiate LoRa UART interface
+    this->transport.end();
+    this->transport.begin(baudrate);
+
+    // Wait for serial port to connect
+    while (!this->transport) {;}
+
+    // Drop bytes received at the previous baud rate
+    while (this->transport.available()) {
+        this->transport.read();
+    }
+    this->rxLineLen = 0;
+
+    // Test UART communication (first line may be lost while the modem UART syncs)
+    for (uint8_t i = 0; i < 2; i++) {
+        statusCode = execATCmd("AT");
+        if ((statusCode == LORA_STATUS_OK) && (strcmp(this->atResponse, "+AT: OK") == 0)) {
+            if (Log::enabled) {
+                Log::print(F("[OK]"));
+                Log::flush();
+            }
+            return true;
+        }
+    }
+    if (Log::enabled) {
+        Log::print(F("[ERROR]"));
+        Log::flush();
+    }
+
+    return false;
+}
+
+template <class Transport, class Log>
+String RHF76<Transport, Log>::getFWVersion() {
+    uint8_t statusCode = LORA_STATUS_OK;
+    String at_cmd = "";
+
+    at_cmd = "AT+VER";
+    statusCode = execATCmd(at_cmd.c_str());
+    if (statusCode != LORA_STATUS_OK) {
+        return "";
+    }
+    return String(this->atResponse + 6);
+}
+
+/**
+ * @fn resetLoRaModule()
+ * @brief Reset LoRa module. 
+ */ 
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::resetLoRaModule() {    
+    uint8_t statusCode = LORA_STATUS_OK;
+    String at_cmd = "";
+
+    if (Log::enabled) {
+        Log::print(F("\n\t\tReseting LoRa module... "));        
+        Log::flush();
+    }
+
+    at_cmd = "AT+RESET";    
+    statusCode = execATCmd(at_cmd.c_str());
+    printATResponse(statusCode);
+
+    return statusCode;
+}
+
+/**
+ * @fn setLoRaBaseBand()
+ * @brief Set LoRa base band. 
+ */ 
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::setLoRaBaseBand() {    
+    uint8_t statusCode = LORA_STATUS_OK;
+    String at_cmd = "";
+
+    if (Log::enabled) {
+        Log::print(F("\n\t\tSetting LoRa base band... "));        
+        Log::flush();
+    }
+
+    at_cmd = "AT+DR=";
+    at_cmd.concat(getLoRaBaseBandStr(this->config.baseband));
+    statusCode = execATCmd(at_cmd.c_str());
+    printATResponse(statusCode);
+
+    return statusCode;
+}
+
+/**
+ * @fn loraBand_toString(LoRaBand_e loraBand)
+ * @brief Convert LoRa band enum to String.
+ * @param[in] lora_band - LoRa port used to send message.
+ * @return String - LoRa band string.
+ */ 
+template <class Transport, class Log>
+String RHF76<Transport, Log>::getLoRaBaseBandStr(LoRaBaseBand_e loraBaseBand) {
+    switch (loraBaseBand) {
+        case EU868:
+            return "EU868";
+        case US915:
+            return "US915";
+        case AU920:
+            return "AU920";
+        default:
+            return "ERROR";
+    }
+}
+
+/**
+ * @fn setLoRaSubBand()
+ * @brief Sets the sub-band. This will disable all channels not belonging to the specified sub-band.
+ * @details Sub-band N (1 - 8) keeps the eight 125 kHz channels (N-1)*8 to (N-1)*8+7 and the 
+ *          500 kHz channel 64+(N-1). The whole mask is applied with a single "AT+CH=NUM" 
+ *          command; modem firmwares without this syntax fall back to one command per channel.
+ */ 
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::setLoRaSubBand() {    
+    uint8_t statusCode = LORA_STATUS_OK;
+    String at_cmd = "";
+
+    if (Log::enabled) {
+        Log::print(F("\n\t\tSetting LoRa sub band... "));        
+        Log::flush();
+    }
+
+    // Sub bands only exist in US915/AU920 base bands
+    if ((this->config.baseband == EU868) || (this->config.subband < 1) || (this->config.subband > 8)) {
+        if (Log::enabled) {
+            Log::print(F("[SKIPPED]"));
+            Log::flush();
+        }
+        return LORA_STATUS_OK;
+    }
+
+    uint8_t firstCh = (this->config.subband - 1) * 8;
+    uint8_t lastCh = firstCh + 7;
+    uint8_t wideCh = 64 + (this->config.subband - 1);
+
+    at_cmd = "AT+CH=NUM, ";
+    at_cmd.concat(firstCh);
+    at_cmd.concat("-");
+    at_cmd.concat(lastCh);
+    at_cmd.concat(",");
+    at_cmd.concat(wideCh);
+    statusCode = execATCmd(at_cmd.c_str());
+    if ((statusCode == LORA_STATUS_OK) && (strstr(this->atResponse, "NUM") == NULL)) {
+        statusCode = LORA_STATUS_AT_ERROR;
+    }
+
+    // Modem does not support channel list, so disable channels one by one
+    if (statusCode == LORA_STATUS_AT_ERROR) {
+        for (uint8_t i = 0; i <= 71; i++) {
+            if (((i >= firstCh) && (i <= lastCh)) || (i == wideCh)) {
+                continue;
+            }
+            at_cmd = "AT+CH=";
+            at_cmd.concat(i);
+            at_cmd.concat(", 0");
+            statusCode = execATCmd(at_cmd.c_str());
+            if (statusCode != LORA_STATUS_OK) {
+                break;
+            }
+        }
+    }
+    printATResponse(statusCode);
+
+    return statusCode;
+}
+
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::setLoRaClass() {
+    uint8_t statusCode = LORA_STATUS_OK;
+    String at_cmd = "";
+
+    if (Log::enabled) {
+        Log::print(F("\n\t\tSetting LoRa class... "));
+        Log::flush();
+    }
+    
+    at_cmd = "AT+CLASS=";
+    at_cmd.concat(getLoRaClassStr(this->config.op_class));
+    statusCode = execATCmd(at_cmd.c_str());
+    printATResponse(statusCode);
+
+    return statusCode;
+}
+
+/**
+ * @fn getLoRaClassStr()
+ * @brief Convert LoRa operation class enum to String.
+ * @param[in] lora_class - LoRa operation class enum.
+ * @return String - LoRa class operation string.
+ */ 
+template <class Transport, class Log>
+String RHF76<Transport, Log>::getLoRaClassStr(LoRaClass_e loraClass) {    
+    switch (loraClass) {
+        case A:
+            return "A";
+        case B:
+            return "B";
+        case C:
+            return "C";
+        default:
+            return "ERROR";
+    }
+}
+
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::setLoRaTxPwr() {
+    uint8_t statusCode = LORA_STATUS_OK;
+    String at_cmd = "";
+
+    if (Log::enabled) {
+        Log::print(F("\n\t\tSetting LoRa transmission power (in dBm)... "));
+        Log::flush();
+    }
+    
+    at_cmd = "AT+POWER=";
+    at_cmd.concat(getLoRaTxPwrStr(this->config.tx_power));
+    statusCode = execATCmd(at_cmd.c_str());
+    printATResponse(statusCode);
+
+    return statusCode;
+}
+
+/**
+ * @fn getLoRaTxPwrStr(LoRaTxPower_e loraTxPower)
+ * @brief Convert LoRa transmission power enum to String.
+ * @param[in] loraTxPower - LoRa transmission power enum.
+ * @return String - LoRa transmission power string.
+ */ 
+template <class Transport, class Log>
+String RHF76<Transport, Log>::getLoRaTxPwrStr(LoRaTxPower_e loraTxPower) {
+    switch (loraTxPower) {
+        case dBm30:
+            return "30";
+        case dBm28:
+            return "28";
+        case dBm26:
+            return "26";
+        case dBm24:
+            return "24";
+        case dBm22:
+            return "22";
+        case dBm20:
+            return "20";
+        case dBm18:
+            return "18";
+        case dBm16:
+            return "16";
+        case dBm14:
+            return "14";
+        case dBm12:
+            return "12";
+        case dBm10:
+            return "10";
+        default:
+            return "ERROR";
+    }
+}
+
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::setLoRaUpDR() {
+    uint8_t statusCode = LORA_STATUS_OK;
+    String at_cmd = "";
+    
+    if (Log::enabled) {
+        Log::print(F("\n\t\tSetting LoRa uplink datarate... "));
+        Log::flush();
+    }
+    
+    at_cmd = "AT+DR=";
+    at_cmd.concat(getLoRaUpDRStr(this->config.uplink_dr));
+    statusCode = execATCmd(at_cmd.c_str());
+    printATResponse(statusCode);
+
+    return statusCode;
+}
+
+/**
+ * @fn getLoRaUpDRStr(LoRaDR_e loraDR)
+ * @brief Convert LoRa datarate enum to String.
+ * @param[in] loraDR - LoRa datarate enum.
+ * @return String - LoRa datarate string.
+ */ 
+template <class Transport, class Log>
+String RHF76<Transport, Log>::getLoRaUpDRStr(LoRaDR_e loraDR) {
+    switch (loraDR) {
+        case DR0:
+            return "DR0";
+        case DR1:
+            return "DR1";
+        case DR2:
+            return "DR2";
+        case DR3:
+            return "DR3";
+        case DR4:
+            return "DR4";
+        case DR5:
+            return "DR5";
+        case DR6:
+            return "DR6";
+        case DR7:
+            return "DR7";
+        case DR8:
+            return "DR8";
+        case DR9:
+            return "DR9";
+        case DR10:
+            return "DR10";
+        case DR11:
+            return "DR11";
+        case DR12:
+            return "DR12";
+        case DR13:
+            return "DR13";
+        case DR14:
+            return "DR14";
+        case DR15:
+            return "DR15";
+        default:
+            return "ERROR";
+    }
+}
+
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::setLoRaADR() {
+    uint8_t statusCode = LORA_STATUS_OK;
+    String at_cmd = "";
+
+    if (Log::enabled) {
+        Log::print(F("\n\t\tSetting LoRa ADR... "));
+        Log::flush();
+    }
+    
+    at_cmd = "AT+ADR=";
+    at_cmd.concat(getLoRaBoolStr(this->config.adr));
+    statusCode = execATCmd(at_cmd.c_str());
+    printATResponse(statusCode);
+
+    return statusCode;
+}
+
+/**
+ * @fn getLoRaBoolStr(LoRaBool_e loraBool)
+ * @brief Convert LoRa boolean enum to String.
+ * @param[in] loraBool - LoRa boolean enum.
+ * @return String - LoRa boolean string.
+ */ 
+template <class Transport, class Log>
+String RHF76<Transport, Log>::getLoRaBoolStr(LoRaBool_e loraBool) {
+    switch (loraBool) {
+        case ON:
+            return "ON";
+        case OFF:
+            return "OFF";
+        default:
+            return "ERROR";
+    }
+}
+
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::setLoRaAuthMode() {
+    uint8_t statusCode = LORA_STATUS_OK;
+    String at_cmd = "";
+
+    if (Log::enabled) {
+        Log::print(F("\n\t\tSetting LoRa authentication mode... "));
+        Log::flush();
+    }
+    
+    at_cmd = "AT+MODE=";
+    at_cmd.concat(getLoRaAuthModeStr(this->config.auth_mode));
+    statusCode = execATCmd(at_cmd.c_str());
+    printATResponse(statusCode);
+
+    return statusCode;
+}
+
+
+/**
+ * @fn getLoRaAuthModeStr(LoRaAuthMode_e loraAuthMode)
+ * @brief Convert LoRa authentication mode enum to String.
+ * @param[in] loraAuthMode - LoRa authentication mode enum.
+ * @return String - LoRa authentication mode string.
+ */ 
+template <class Transport, class Log>
+String RHF76<Transport, Log>::getLoRaAuthModeStr(LoRaAuthMode_e loraAuthMode) {
+    switch (loraAuthMode) {
+        case LWABP:
+            return "LWABP";
+        case LWOTAA:
+            return "LWOTAA";
+        case LWTEST:
+            return "LWTEST";
+        default:
+            return "ERROR";
+    }
+}
+
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::setLoRaDevEUI() {
+    uint8_t statusCode = LORA_STATUS_OK;
+    String at_cmd = "";
+
+    if (Log::enabled) {
+        Log::print(F("\n\t\tSetting LoRa DevEUI... "));
+        Log::flush();
+    }
+    
+    at_cmd = "AT+ID=DevEui,\"";
+    at_cmd.concat(this->config.dev_eui);
+    at_cmd.concat("\"");
+    statusCode = execATCmd(at_cmd.c_str());
+    printATResponse(statusCode);
+
+    return statusCode;
+}
+
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::setLoRaAppEUI() {
+    uint8_t statusCode = LORA_STATUS_OK;
+    String at_cmd = "";
+    
+    if (Log::enabled) {
+        Log::print(F("\n\t\tSetting LoRa AppEUI... "));
+        Log::flush();
+    }
+    
+    at_cmd = "AT+ID=AppEui,\"";
+    at_cmd.concat(this->config.app_eui);
+    at_cmd.concat("\"");
+    statusCode = execATCmd(at_cmd.c_str());
+    printATResponse(statusCode);
+
+    return statusCode;
+}
+
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::setLoRaDevAddr() {
+    uint8_t statusCode = LORA_STATUS_OK;
+    String at_cmd = "";
+     
+    if (Log::enabled) {
+        Log::print(F("\n\t\tSetting LoRa device address... "));
+        Log::flush();
+    }
+    
+    at_cmd = "AT+ID=DevAddr,\"";
+    at_cmd.concat(this->config.dev_addr);
+    at_cmd.concat("\"");
+    statusCode = execATCmd(at_cmd.c_str());
+    printATResponse(statusCode);
+
+    return statusCode;
+}
+
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::setLoRaNwkSKey() {
+    uint8_t statusCode = LORA_STATUS_OK;
+    String at_cmd = "";
+
+    if (Log::enabled) {
+        Log::print(F("\n\t\tSetting LoRa network session key... "));
+        Log::flush();
+    }
+    
+    at_cmd = "AT+KEY=NwkSKey,\"";
+    at_cmd.concat(this->config.nwks_key);
+    at_cmd.concat("\"");
+    statusCode = execATCmd(at_cmd.c_str());
+    printATResponse(statusCode);
+
+    return statusCode;
+}
+
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::setLoRaAppSKey() {
+    uint8_t statusCode = LORA_STATUS_OK;
+    String at_cmd = "";
+
+    if (Log::enabled) {
+        Log::print(F("\n\t\tSetting LoRa application session key... "));
+        Log::flush();
+    }
+    
+    at_cmd = "AT+KEY=AppSKey,\"";
+    at_cmd.concat(this->config.apps_key);
+    at_cmd.concat("\"");
+    statusCode = execATCmd(at_cmd.c_str());
+    printATResponse(statusCode);
+
+    return statusCode;
+}
+
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::setLoRaAppKey() {
+    uint8_t statusCode = LORA_STATUS_OK;
+    String at_cmd = "";
+
+    if (Log::enabled) {
+        Log::print(F("\n\t\tSetting LoRa application key... "));
+        Log::flush();
+    }
+    
+    at_cmd = "AT+KEY=AppKey,\"";
+    at_cmd.concat(this->config.app_key);
+    at_cmd.concat("\"");
+    statusCode = execATCmd(at_cmd.c_str());
+    printATResponse(statusCode);
+
+    return statusCode;
+}
+    
+ /**
+ * @fn sendNoAckMsgHex(uint8_t port, char* msg_ptr, uint8_t msg_size)
+ * @brief Send unconfirmed messages in a hexadecimal format.
+ * @param[in] port - LoRa port used to send message.
+ * @param[in] msg_ptr - pointer to message.
+ * @param[in] msg_size - message size.
+ * @retval status code - LORA_STATUS_OK if transmission started or error code. 
+ *         Transmission result is reported by \ref getTxStatus() and the TX callback.
+ */ 
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::sendNoAckMsgHex(uint8_t port, String buf) {    
+    uint8_t statusCode = LORA_STATUS_OK;
+    String at_cmd = "";
+
+    // Check if LoRa modem is free, joined and has airtime left
+    statusCode = this->checkTxAllowed(buf.length() / 2);
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    // Set LoRa port
+    if (Log::enabled) {
+        Log::print(F("\nSending LoRa noACK hexadecimal message..."));
+        Log::flush();
+    }
+    statusCode = setLoRaPort(port);
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+    requestLinkCheck();
+
+    // Send LoRa message
+    if (Log::enabled) {
+        Log::print(F("\nSending message... "));
+        Log::flush();
+    }
+    at_cmd = "AT+MSGHEX=\"";
+    at_cmd.concat(buf);
+    at_cmd.concat("\"");
+
+    // Modem answers "Done" after both RX windows, so only start the transaction 
+    // here and let poll() collect the response
+    this->txConfirmed = false;
+    return startTx(beginATCmd(at_cmd.c_str(), LORA_TX_TIMEOUT, true), buf.length() / 2);
+}
+
+/**
+ * @fn sendNoAckMsgHex(uint8_t port, const uint8_t* buf, size_t size)
+ * @brief Send unconfirmed binary messages. 
+ * @details Bytes are hex encoded straight into the modem UART while the AT command 
+ *          is written, so no intermediate String is allocated.
+ * @param[in] port - LoRa port used to send message.
+ * @param[in] buf - pointer to message.
+ * @param[in] size - message size (in bytes).
+ * @retval status code - LORA_STATUS_OK if transmission started or error code.
+ *         Transmission result is reported by \ref getTxStatus() and the TX callback.
+ */ 
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::sendNoAckMsgHex(uint8_t port, const uint8_t* buf, size_t size) {
+    uint8_t statusCode = LORA_STATUS_OK;
+
+    // Check if LoRa modem is free, joined and has airtime left
+    statusCode = this->checkTxAllowed(size);
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    if (Log::enabled) {
+        Log::print(F("\nSending LoRa noACK hexadecimal message..."));
+        Log::flush();
+    }
+    statusCode = setLoRaPort(port);
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+    requestLinkCheck();
+
+    if (Log::enabled) {
+        Log::print(F("\nSending message... "));
+        Log::flush();
+    }
+
+    this->txConfirmed = false;
+    return startTx(beginATCmdHex("AT+MSGHEX", buf, size, LORA_TX_TIMEOUT, true), size);
+}
+
+/**
+ * @fn RHF76::beginATCmdHex(const char* cmd, const uint8_t* buf, size_t size, uint16_t timeout, bool untilDone)
+ * @brief Send an AT command with a hex encoded argument (cmd="0A1B...") without 
+ *        waiting for its response.
+ * @param[in] cmd - AT command name (e.g. "AT+MSGHEX").
+ * @param[in] buf - bytes to be hex encoded.
+ * @param[in] size - number of bytes.
+ * @param[in] timeout - command deadline (in ms).
+ * @param[in] untilDone - wait for the "Done" line instead of the first response line.
+ * @retval LORA_STATUS_OK - command sent.
+ * @retval LORA_STATUS_BUSY - another AT transaction is still in progress.
+ */
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::beginATCmdHex(const char* cmd, const uint8_t* buf, size_t size, uint16_t timeout, bool untilDone) {
+    if (poll() == LORA_AT_WAITING) {
+        return LORA_STATUS_BUSY;
+    }
+    wakeModem();
+
+    writeATCmdHex(cmd, buf, size, timeout, untilDone);
+
+    return LORA_STATUS_OK;
+}
+
+/**
+ * @fn RHF76::writeATCmdHex(const char* cmd, const uint8_t* buf, size_t size, uint16_t timeout, bool untilDone)
+ * @brief Write an AT command with a hex encoded argument, without checking if the 
+ *        modem is busy (see \ref beginATCmdHex()).
+ */
+template <class Transport, class Log>
+void RHF76<Transport, Log>::writeATCmdHex(const char* cmd, const uint8_t* buf, size_t size, uint16_t timeout, bool untilDone) {
+    armATCmd(cmd, timeout, untilDone);
+    this->transport.print(cmd);
+    this->transport.print("=\"");
+    printHex(this->transport, buf, size);
+    this->transport.print("\"\r\n");
+}
+
+/**
+ * @fn RHF76::setLoRaPort(uint8_t port)
+ * @brief Set LoRa port of the next messages.
+ * @param[in] port - LoRa port.
+ */
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::setLoRaPort(uint8_t port) {
+    uint8_t statusCode = LORA_STATUS_OK;
+    char at_cmd[12] = "AT+PORT=";
+
+    if (Log::enabled) {
+        Log::print(F("\n\tSetting LoRa port... "));
+        Log::flush();
+    }
+
+    utoa(port, at_cmd + 8, 10);
+    statusCode = execATCmd(at_cmd);
+    printATResponse(statusCode);
+
+    return statusCode;
+}
+
+/**
+ * @fn sendAckMsgHex(uint8_t port, const uint8_t* buf, size_t size)
+ * @brief Send confirmed binary messages. 
+ * @details Message is copied to the driver, so it can be sent again (up to 
+ *          \ref LoRaConfig_t::retry times, with exponential backoff starting at 
+ *          \ref LoRaConfig_t::retry_backoff) while the ACK is not received. 
+ * @param[in] port - LoRa port used to send message.
+ * @param[in] buf - pointer to message.
+ * @param[in] size - message size (in bytes).
+ * @retval status code - LORA_STATUS_OK if transmission started or error code.
+ *         Transmission result is reported by \ref getTxStatus() and the TX callback.
+ */ 
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::sendAckMsgHex(uint8_t port, const uint8_t* buf, size_t size) {
+    uint8_t statusCode = LORA_STATUS_OK;
+
+    // Check if LoRa modem is free, joined and has airtime left
+    statusCode = this->checkTxAllowed(size);
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    if (Log::enabled) {
+        Log::print(F("\nSending LoRa ACK hexadecimal message..."));
+        Log::flush();
+    }
+    statusCode = setLoRaPort(port);
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+    requestLinkCheck();
+
+    if (Log::enabled) {
+        Log::print(F("\nSending message... "));
+        Log::flush();
+    }
+    memcpy(this->txBuffer, buf, size);
+    this->txSize = size;
+    this->txConfirmed = true;
+
+    return startTx(beginATCmdHex("AT+CMSGHEX", this->txBuffer, this->txSize, LORA_TX_TIMEOUT, true), this->txSize);
+}
+
+/**
+ * @fn RHF76::setLoRaRetry()
+ * @brief Disable modem internal retries of confirmed messages, since they are 
+ *        handled by the driver. Older firmwares rejecting it are not an error.
+ */
+template <class Transport, class Log>
+uint8_t RHF76<Transport, Log>::setLoRaRetry() {
+    uint8_t statusCode = LORA_STATUS_OK;
+
+    if (Log::enabled) {
+        Log::print(F("\n\t\tSetting LoRa confirmed message retry times... "));
+        Log::flush();
+    }
+
+    statusCode = execATCmd("AT+RETRY=0");
+    printATResponse(statusCode);
+
+    return statusCode;
+}
+
+#endif // __RHF76_H__
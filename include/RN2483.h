@@ -0,0 +1,873 @@
+/**
+ * @file RN2483.h
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Microchip RN2483/RN2903 LoRaWAN modem backend.
+ * @version alpha
+ * @since 17/10/2026
+ * @date 17/10/2026
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __RN2483_H__
+#define __RN2483_H__
+
+#include <Arduino.h>
+#include "LoRa.h"
+
+/**
+ * \def RN2483_UART_BAUDRATE
+ * Baud rate of the modem UART (fixed by the modem firmware).
+ */
+#define RN2483_UART_BAUDRATE        57600
+
+/**
+ * \def RN2483_RX_BUFFER_SIZE
+ * Size of the modem line buffer (fits a "mac_rx <port> <hex payload>" line).
+ */
+#define RN2483_RX_BUFFER_SIZE       (12 + (2 * LORA_MAX_PAYLOAD_SIZE))
+
+/**
+ * \def RN2483_RESET_TIMEOUT
+ * Deadline (in ms) of the reset command (answered by the firmware version line).
+ */
+#define RN2483_RESET_TIMEOUT        2000
+
+/**
+ * \def RN2483_SAVE_TIMEOUT
+ * Deadline (in ms) of the "mac save" command.
+ */
+#define RN2483_SAVE_TIMEOUT         2000
+
+/**
+ * @class RN2483
+ * @brief RN2483 (EU868) and RN2903 (US915/AU920) LoRaWAN modem backend.
+ * @details Commands are plain text lines ("mac tx cnf 2 0A1B"). Transmission and join
+ *          commands answer twice: "ok" when accepted and the result ("mac_tx_ok",
+ *          "mac_rx <port> <data>", "accepted"...) after the RX windows, which is
+ *          handled by \ref poll(). Confirmed messages are retried by the modem itself
+ *          ("mac set retx") and its frame counters are kept with "mac save".
+ * @tparam Transport - modem UART (HardwareSerial or any class with begin(), end(),
+ *         available(), read(), write(uint8_t) and print(const char*)).
+ * @tparam Log - logging policy (\ref LoRaSerialLog or \ref LoRaNoLog).
+ */
+template <class Transport, class Log>
+class RN2483 : public LoRaRadio<RN2483<Transport, Log>, Log> {
+    private:
+        Transport& transport;
+        char rxLine[RN2483_RX_BUFFER_SIZE];
+        uint8_t rxLineLen = 0;
+        char cmdResponse[LORA_RX_BUFFER_SIZE];
+        LoRaATState_e cmdState = LORA_AT_IDLE;
+        bool cmdTwoLines = false;
+        uint32_t cmdStart = 0;
+        uint32_t cmdTimeout = 0;
+        uint8_t cmdError = LORA_STATUS_OK;
+        bool txConfirmed = false;
+        uint32_t joinRetryStart = 0;
+        uint32_t joinRetryDelay = 0;
+        uint8_t joinAttempt = 0;
+        uint8_t fcntCount = 0;
+        bool savePending = false;
+        bool saveRunning = false;
+        bool drPending = false;
+        bool drRunning = false;
+        bool tasksLocked = false;
+        uint8_t beginCmd(const char* cmd, uint32_t timeout = LORA_CMD_TIMEOUT, bool twoLines = false);
+        uint8_t execCmd(const char* cmd, uint32_t timeout = LORA_CMD_TIMEOUT, bool twoLines = false);
+        uint8_t getCmdStatus();
+        void processLine();
+        void parseDownlink(const char* line);
+        static uint8_t getLineError(const char* text);
+        void printCmdResponse(uint8_t statusCode);
+        uint8_t setCmd(const __FlashStringHelper* msg, const String& cmd);
+        uint8_t configureModule();
+        bool isConfigStored();
+        uint8_t restoreFCnt();
+        bool matchCmd(const char* cmd, const char* value);
+        uint8_t setLoRaSubBand();
+        uint8_t getLoRaPwrIdx();
+        uint8_t beginTxCmd(bool confirmed, uint8_t port, const char* hex, const uint8_t* buf, size_t size);
+        void checkTx();
+        void checkSave();
+        void checkDR();
+        void checkJoin();
+
+    public:
+        explicit RN2483(Transport& transport) : transport(transport) {}
+        uint8_t init(LoRaConfig_t config);
+        LoRaATState_e poll();
+        const char* getATResponse();
+        bool isBusy();
+        String getFWVersion();
+        uint8_t sendNoAckMsgHex(uint8_t port, String buf);
+        uint8_t sendNoAckMsgHex(uint8_t port, const uint8_t* buf, size_t size);
+        uint8_t sendAckMsgHex(uint8_t port, const uint8_t* buf, size_t size);
+};
+
+/****************************************************************************************
+ * FUNCTIONS IMPLEMENTATIONS
+ ****************************************************************************************/
+
+/**
+ * @fn RN2483::init(LoRaConfig_t config)
+ * @brief Initialize LoRa interface.
+ * @details Modem is restarted ("sys reset", which restores the state of the last
+ *          "mac save") and only configured again when the fingerprint stored in EEPROM 
+ *          or the modem identifiers differ from \p config, since "mac reset" also 
+ *          clears the frame counters. The ABP uplink counter of a kept session is moved
+ *          past the messages sent since that save (see \ref restoreFCnt()). ABP sessions
+ *          are activated here, OTAA joins are started by \ref poll().
+ * @param[in] config - struct with LoRa configuration (see \ref LoRaConfig_t).
+ * @retval status code - 0 if successful initialization or error code.
+ */
+template <class Transport, class Log>
+uint8_t RN2483<Transport, Log>::init(LoRaConfig_t config) {
+    uint8_t statusCode = LORA_STATUS_UNINITIALIZED;
+    this->setConfig(config);
+
+    // Baud rate is fixed by the modem
+    this->transport.begin(RN2483_UART_BAUDRATE);
+
+    if (Log::enabled) {
+        Log::print(F("\n\t\tReseting LoRa module... "));
+        Log::flush();
+    }
+    statusCode = execCmd("sys reset", RN2483_RESET_TIMEOUT);
+    printCmdResponse(statusCode);
+    if (statusCode != LORA_STATUS_OK) {
+        return LORA_STATUS_UART_FAIL;
+    }
+
+    // Keep the saved session (and frame counters) if modem already holds the configuration
+    if (isConfigStored()) {
+        if (Log::enabled) {
+            Log::print(F("\n\t\tModem configuration is up to date"));
+            Log::flush();
+        }
+        if (this->config.auth_mode == LWABP) {
+            statusCode = restoreFCnt();
+            if (statusCode != LORA_STATUS_OK) {
+                return statusCode;
+            }
+        }
+    } else {
+        this->saveConfigRecord(false);
+        statusCode = configureModule();
+        if (statusCode != LORA_STATUS_OK) {
+            return statusCode;
+        }
+        this->saveConfigRecord(true);
+    }
+
+    if (this->config.auth_mode == LWABP) {
+        if (Log::enabled) {
+            Log::print(F("\n\t\tJoining LoRaWAN network (ABP)... "));
+            Log::flush();
+        }
+        statusCode = execCmd("mac join abp", LORA_CMD_TIMEOUT, true);
+        printCmdResponse(statusCode);
+        if (statusCode == LORA_STATUS_OK) {
+            this->joinStatus = LORA_JOINED;
+        }
+    } else {
+        this->joinStatus = LORA_NOT_JOINED;
+        this->joinRetryDelay = 0;
+        this->joinRetryStart = millis();
+    }
+
+    return statusCode;
+}
+
+/**
+ * @fn RN2483::configureModule()
+ * @brief Push the configuration to the modem and save it ("mac save").
+ */
+template <class Transport, class Log>
+uint8_t RN2483<Transport, Log>::configureModule() {
+    uint8_t statusCode = LORA_STATUS_OK;
+    String cmd = "";
+
+    if (this->config.op_class == B) {
+        return LORA_STATUS_INVALID_PARAM;
+    }
+
+    // RN2483 (EU868) selects its band on reset, RN2903 has a single one
+    statusCode = setCmd(F("Setting LoRa base band"), (this->config.baseband == EU868) ? "mac reset 868" : "mac reset");
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+    statusCode = setLoRaSubBand();
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    cmd = "mac set deveui ";
+    cmd.concat(this->config.dev_eui);
+    statusCode = setCmd(F("Setting LoRa DevEUI"), cmd);
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+    if (this->config.auth_mode == LWOTAA) {
+        cmd = "mac set appeui ";
+        cmd.concat(this->config.app_eui);
+        statusCode = setCmd(F("Setting LoRa AppEUI"), cmd);
+        if (statusCode != LORA_STATUS_OK) {
+            return statusCode;
+        }
+        cmd = "mac set appkey ";
+        cmd.concat(this->config.app_key);
+        statusCode = setCmd(F("Setting LoRa AppKey"), cmd);
+    } else {
+        cmd = "mac set devaddr ";
+        cmd.concat(this->config.dev_addr);
+        statusCode = setCmd(F("Setting LoRa device address"), cmd);
+        if (statusCode != LORA_STATUS_OK) {
+            return statusCode;
+        }
+        cmd = "mac set nwkskey ";
+        cmd.concat(this->config.nwks_key);
+        statusCode = setCmd(F("Setting LoRa network session key"), cmd);
+        if (statusCode != LORA_STATUS_OK) {
+            return statusCode;
+        }
+        cmd = "mac set appskey ";
+        cmd.concat(this->config.apps_key);
+        statusCode = setCmd(F("Setting LoRa application session key"), cmd);
+    }
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    cmd = "mac set pwridx ";
+    cmd.concat(getLoRaPwrIdx());
+    statusCode = setCmd(F("Setting LoRa transmission power"), cmd);
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+    cmd = "mac set dr ";
+    cmd.concat((uint8_t)this->config.uplink_dr);
+    statusCode = setCmd(F("Setting LoRa uplink datarate"), cmd);
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+    statusCode = setCmd(F("Setting LoRa ADR"), (this->config.adr == ON) ? "mac set adr on" : "mac set adr off");
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+    cmd = "mac set retx ";
+    cmd.concat(this->config.retry);
+    statusCode = setCmd(F("Setting LoRa retry"), cmd);
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+    statusCode = setCmd(F("Setting LoRa class"), (this->config.op_class == C) ? "mac set class c" : "mac set class a");
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    return setCmd(F("Saving LoRa configuration"), "mac save");
+}
+
+/**
+ * @fn RN2483::isConfigStored()
+ * @brief Check if the modem already holds the configuration.
+ * @details Compare the fingerprint stored in EEPROM and the modem identifiers, so a
+ *          replaced or factory reset modem is configured again.
+ * @retval true - modem configuration is up to date.
+ * @retval false - modem must be configured.
+ */
+template <class Transport, class Log>
+bool RN2483<Transport, Log>::isConfigStored() {
+    if (!this->isConfigSaved() || !matchCmd("mac get deveui", this->config.dev_eui.c_str())) {
+        return false;
+    }
+
+    // DevAddr is assigned by the network in OTAA mode
+    if (this->config.auth_mode == LWOTAA) {
+        return matchCmd("mac get appeui", this->config.app_eui.c_str());
+    }
+    return matchCmd("mac get devaddr", this->config.dev_addr.c_str());
+}
+
+/**
+ * @fn RN2483::restoreFCnt()
+ * @brief Move the ABP uplink counter past the messages sent since the last "mac save".
+ * @details "sys reset" restores the counters of the last "mac save", which runs every
+ *          \ref LORA_FCNT_SAVE_INTERVAL messages, so up to that many counters were already
+ *          used and would be rejected by the network as replays. The counter is moved that
+ *          far ahead and saved at once (a node reset more often than that would restore the
+ *          same counter again).
+ * @retval status code - LORA_STATUS_OK or error code.
+ */
+template <class Transport, class Log>
+uint8_t RN2483<Transport, Log>::restoreFCnt() {
+    uint8_t statusCode = execCmd("mac get upctr");
+    if ((statusCode != LORA_STATUS_OK) || !isdigit(this->cmdResponse[0])) {
+        return LORA_STATUS_UART_FAIL;
+    }
+
+    String cmd = "mac set upctr ";
+    cmd.concat(strtoul(this->cmdResponse, NULL, 10) + LORA_FCNT_SAVE_INTERVAL);
+    statusCode = setCmd(F("Restoring LoRa frame counters"), cmd);
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+    if (Log::enabled) {
+        Log::print(F("\n\t\tSaving LoRa frame counters... "));
+        Log::flush();
+    }
+    statusCode = execCmd("mac save", RN2483_SAVE_TIMEOUT);
+    printCmdResponse(statusCode);
+    this->fcntCount = 0;
+
+    return statusCode;
+}
+
+/**
+ * @fn RN2483::matchCmd(const char* cmd, const char* value)
+ * @brief Send a query command and compare the answer (case insensitive).
+ */
+template <class Transport, class Log>
+bool RN2483<Transport, Log>::matchCmd(const char* cmd, const char* value) {
+    return (execCmd(cmd) == LORA_STATUS_OK) && (strcasecmp(this->cmdResponse, value) == 0);
+}
+
+/**
+ * @fn RN2483::setLoRaSubBand()
+ * @brief Enable only the channels of \ref LoRaConfig_t::subband (US915/AU920 base bands).
+ */
+template <class Transport, class Log>
+uint8_t RN2483<Transport, Log>::setLoRaSubBand() {
+    uint8_t statusCode = LORA_STATUS_OK;
+    String cmd = "";
+
+    // Sub bands only exist in US915/AU920 base bands
+    if ((this->config.baseband == EU868) || (this->config.subband < 1) || (this->config.subband > 8)) {
+        return LORA_STATUS_OK;
+    }
+
+    if (Log::enabled) {
+        Log::print(F("\n\t\tSetting LoRa sub band... "));
+        Log::flush();
+    }
+    uint8_t firstCh = (this->config.subband - 1) * 8;
+    uint8_t lastCh = firstCh + 7;
+    uint8_t wideCh = 64 + (this->config.subband - 1);
+    for (uint8_t i = 0; i <= 71; i++) {
+        cmd = "mac set ch status ";
+        cmd.concat(i);
+        cmd.concat((((i >= firstCh) && (i <= lastCh)) || (i == wideCh)) ? " on" : " off");
+        statusCode = execCmd(cmd.c_str());
+        if (statusCode != LORA_STATUS_OK) {
+            break;
+        }
+    }
+    printCmdResponse(statusCode);
+
+    return statusCode;
+}
+
+/**
+ * @fn RN2483::getLoRaPwrIdx()
+ * @brief Convert \ref LoRaConfig_t::tx_power to the modem power index.
+ * @details RN2483 indexes 1 to 5 are 14, 11, 8, 5 and 2 dBm; RN2903 indexes 5 to 10
+ *          are 20 down to 10 dBm (same as \ref LoRaTxPower_e).
+ */
+template <class Transport, class Log>
+uint8_t RN2483<Transport, Log>::getLoRaPwrIdx() {
+    uint8_t index = (uint8_t)this->config.tx_power;
+
+    if (this->config.baseband != EU868) {
+        return (index < 5) ? 5 : index;
+    }
+
+    int8_t dBm = 30 - (2 * index);
+    if (dBm >= 14) {
+        return 1;
+    }
+    index = 1 + ((14 - dBm + 1) / 3);
+
+    return (index > 5) ? 5 : index;
+}
+
+/**
+ * @fn RN2483::setCmd(const __FlashStringHelper* msg, const String& cmd)
+ * @brief Send a configuration command and print its result on debug serial.
+ * @param[in] msg - debug message.
+ * @param[in] cmd - modem command.
+ */
+template <class Transport, class Log>
+uint8_t RN2483<Transport, Log>::setCmd(const __FlashStringHelper* msg, const String& cmd) {
+    if (Log::enabled) {
+        Log::print(F("\n\t\t"));
+        Log::print(msg);
+        Log::print(F("... "));
+        Log::flush();
+    }
+    uint8_t statusCode = execCmd(cmd.c_str());
+    printCmdResponse(statusCode);
+
+    return statusCode;
+}
+
+/**
+ * @fn RN2483::beginCmd(const char* cmd, uint32_t timeout, bool twoLines)
+ * @brief Send a command to the modem without waiting for its response.
+ * @param[in] cmd - modem command (without line terminator).
+ * @param[in] timeout - command deadline (in ms).
+ * @param[in] twoLines - wait for the result line that follows the "ok" line.
+ * @retval LORA_STATUS_OK - command sent.
+ * @retval LORA_STATUS_BUSY - another command is still in progress.
+ */
+template <class Transport, class Log>
+uint8_t RN2483<Transport, Log>::beginCmd(const char* cmd, uint32_t timeout, bool twoLines) {
+    if (poll() == LORA_AT_WAITING) {
+        return LORA_STATUS_BUSY;
+    }
+
+    this->cmdResponse[0] = '\0';
+    this->cmdTwoLines = twoLines;
+    this->cmdTimeout = timeout;
+    this->cmdStart = millis();
+    this->cmdState = LORA_AT_WAITING;
+    this->transport.print(cmd);
+    this->transport.print("\r\n");
+
+    return LORA_STATUS_OK;
+}
+
+/**
+ * @fn RN2483::execCmd(const char* cmd, uint32_t timeout, bool twoLines)
+ * @brief Send a command and wait for its response line (or deadline).
+ */
+template <class Transport, class Log>
+uint8_t RN2483<Transport, Log>::execCmd(const char* cmd, uint32_t timeout, bool twoLines) {
+    bool tasksLocked = this->tasksLocked;
+
+    // Background tasks must not start commands while waiting for this one
+    this->tasksLocked = true;
+    uint8_t statusCode = beginCmd(cmd, timeout, twoLines);
+    if (statusCode == LORA_STATUS_OK) {
+        while (poll() == LORA_AT_WAITING) {;}
+        statusCode = getCmdStatus();
+    }
+    this->tasksLocked = tasksLocked;
+
+    return statusCode;
+}
+
+/**
+ * @fn RN2483::poll()
+ * @brief Process bytes received from the modem and run the background tasks (join,
+ *        transmission result, downlink handlers). Never blocks.
+ * @return LoRaATState_e - state of the current command.
+ */
+template <class Transport, class Log>
+LoRaATState_e RN2483<Transport, Log>::poll() {
+    while (this->transport.available()) {
+        char c = (char)this->transport.read();
+        if (c == '\n') {
+            this->rxLine[this->rxLineLen] = '\0';
+            processLine();
+            this->rxLineLen = 0;
+        } else if ((c != '\r') && (this->rxLineLen < (RN2483_RX_BUFFER_SIZE - 1))) {
+            this->rxLine[this->rxLineLen++] = c;
+        }
+    }
+
+    if ((this->cmdState == LORA_AT_WAITING) && ((millis() - this->cmdStart) >= this->cmdTimeout)) {
+        this->cmdState = LORA_AT_TIMEOUT;
+    }
+
+    if (!this->tasksLocked) {
+        this->tasksLocked = true;
+        this->callback_RX();
+        checkTx();
+        checkSave();
+        checkDR();
+        checkJoin();
+        this->tasksLocked = false;
+    }
+
+    return this->cmdState;
+}
+
+/**
+ * @fn RN2483::processLine()
+ * @brief Handle a complete line received from the modem.
+ */
+template <class Transport, class Log>
+void RN2483<Transport, Log>::processLine() {
+    if (this->rxLineLen == 0) {
+        return;
+    }
+
+    if (this->cmdState != LORA_AT_WAITING) {
+        if (Log::enabled) {
+            Log::print(F("\n\t\t"));
+            Log::print(this->rxLine);
+            Log::flush();
+        }
+        return;
+    }
+
+    strncpy(this->cmdResponse, this->rxLine, LORA_RX_BUFFER_SIZE - 1);
+    this->cmdResponse[LORA_RX_BUFFER_SIZE - 1] = '\0';
+    this->cmdError = getLineError(this->rxLine);
+
+    // Command accepted, its result comes after the RX windows
+    if (this->cmdTwoLines && (strcmp(this->rxLine, "ok") == 0)) {
+        this->cmdTwoLines = false;
+        return;
+    }
+
+    if (strncmp(this->rxLine, "mac_rx ", 7) == 0) {
+        parseDownlink(this->rxLine + 7);
+    } else if ((this->cmdError == LORA_STATUS_NO_ACK) && !this->txConfirmed) {
+        this->cmdError = LORA_STATUS_AT_ERROR;
+    }
+    this->cmdState = (this->cmdError == LORA_STATUS_OK) ? LORA_AT_DONE : LORA_AT_ERROR;
+}
+
+/**
+ * @fn RN2483::parseDownlink(const char* line)
+ * @brief Decode a downlink ("<port> <hex data>") and keep it to be dispatched by
+ *        \ref callback_RX().
+ */
+template <class Transport, class Log>
+void RN2483<Transport, Log>::parseDownlink(const char* line) {
+    const char* data = strchr(line, ' ');
+    if (data == NULL) {
+        return;
+    }
+
+    this->rxPort = (uint8_t)atoi(line);
+    this->rxSize = 0;
+    data++;
+    while (isxdigit(data[0]) && isxdigit(data[1]) && (this->rxSize < LORA_MAX_PAYLOAD_SIZE)) {
+        char hexByte[3] = {data[0], data[1], '\0'};
+        this->rxBuffer[this->rxSize++] = (uint8_t)strtoul(hexByte, NULL, 16);
+        data += 2;
+    }
+    this->rxPending = true;
+}
+
+/**
+ * @fn RN2483::getLineError(const char* text)
+ * @brief Classify a response line of the modem.
+ * @retval LORA_STATUS_OK - line is not an error (e.g. "ok", "mac_tx_ok", version).
+ * @retval error code - status code matching the failure.
+ */
+template <class Transport, class Log>
+uint8_t RN2483<Transport, Log>::getLineError(const char* text) {
+    if ((strcmp(text, "invalid_param") == 0) || (strcmp(text, "invalid_data_len") == 0)) {
+        return LORA_STATUS_INVALID_PARAM;
+    } else if (strcmp(text, "not_joined") == 0) {
+        return LORA_STATUS_NOT_JOINED;
+    } else if (strcmp(text, "no_free_ch") == 0) {
+        return LORA_STATUS_NO_BAND;
+    } else if (strcmp(text, "busy") == 0) {
+        return LORA_STATUS_BUSY;
+    } else if (strcmp(text, "mac_err") == 0) {
+        return LORA_STATUS_NO_ACK;
+    } else if ((strcmp(text, "denied") == 0) || (strcmp(text, "silent") == 0) ||
+               (strcmp(text, "mac_paused") == 0) || (strcmp(text, "keys_not_init") == 0) ||
+               (strncmp(text, "frame_counter_err", 17) == 0)) {
+        return LORA_STATUS_AT_ERROR;
+    }
+
+    return LORA_STATUS_OK;
+}
+
+/**
+ * @fn RN2483::getCmdStatus()
+ * @brief Convert the command state to a status code.
+ */
+template <class Transport, class Log>
+uint8_t RN2483<Transport, Log>::getCmdStatus() {
+    switch (this->cmdState) {
+        case LORA_AT_DONE:
+            return LORA_STATUS_OK;
+        case LORA_AT_ERROR:
+            return this->cmdError;
+        case LORA_AT_TIMEOUT:
+            return LORA_STATUS_TIMEOUT;
+        case LORA_AT_WAITING:
+            return LORA_STATUS_BUSY;
+        default:
+            return LORA_STATUS_UNINITIALIZED;
+    }
+}
+
+/**
+ * @fn RN2483::getATResponse()
+ * @brief Get the last response line of the modem (without line terminator).
+ */
+template <class Transport, class Log>
+const char* RN2483<Transport, Log>::getATResponse() {
+    return this->cmdResponse;
+}
+
+/**
+ * @fn RN2483::printCmdResponse(uint8_t statusCode)
+ * @brief Print the response of the last command on debug serial.
+ */
+template <class Transport, class Log>
+void RN2483<Transport, Log>::printCmdResponse(uint8_t statusCode) {
+    if (Log::enabled) {
+        if (statusCode == LORA_STATUS_TIMEOUT) {
+            Log::print(F("[TIMEOUT]"));
+        } else {
+            Log::print(this->cmdResponse);
+        }
+        Log::flush();
+    }
+}
+
+/**
+ * @fn RN2483::isBusy()
+ * @brief Check if the modem is processing a command, a join or a transmission.
+ */
+template <class Transport, class Log>
+bool RN2483<Transport, Log>::isBusy() {
+    return (this->cmdState == LORA_AT_WAITING) || (this->txStatus == LORA_TX_PENDING);
+}
+
+/**
+ * @fn RN2483::getFWVersion()
+ * @brief Get modem firmware version (e.g. "RN2483 1.0.5 Oct 31 2018 15:06:52").
+ */
+template <class Transport, class Log>
+String RN2483<Transport, Log>::getFWVersion() {
+    if (execCmd("sys get ver") != LORA_STATUS_OK) {
+        return "";
+    }
+    return String(this->cmdResponse);
+}
+
+/**
+ * @fn RN2483::checkJoin()
+ * @brief Start the OTAA join when its backoff expires and handle the join result.
+ * @details Failed joins are retried with exponential backoff (from \ref LORA_JOIN_BACKOFF
+ *          up to \ref LORA_JOIN_BACKOFF_MAX, plus jitter).
+ */
+template <class Transport, class Log>
+void RN2483<Transport, Log>::checkJoin() {
+    if (this->config.auth_mode != LWOTAA) {
+        return;
+    }
+
+    if (this->joinStatus == LORA_NOT_JOINED) {
+        if (!isBusy() && ((millis() - this->joinRetryStart) >= this->joinRetryDelay)) {
+            if (Log::enabled) {
+                Log::print(F("\n\tJoining LoRaWAN network... "));
+                Log::flush();
+            }
+            if (beginCmd("mac join otaa", LORA_JOIN_TIMEOUT, true) == LORA_STATUS_OK) {
+                this->joinStatus = LORA_JOINING;
+            }
+        }
+    } else if ((this->joinStatus == LORA_JOINING) && (this->cmdState != LORA_AT_WAITING)) {
+        if (this->cmdState == LORA_AT_DONE) {
+            this->joinStatus = LORA_JOINED;
+            this->joinAttempt = 0;
+        } else {
+            uint32_t backoff = (uint32_t)LORA_JOIN_BACKOFF << this->joinAttempt;
+            if (backoff >= LORA_JOIN_BACKOFF_MAX) {
+                backoff = LORA_JOIN_BACKOFF_MAX;
+            } else {
+                this->joinAttempt++;
+            }
+            this->joinStatus = LORA_NOT_JOINED;
+            this->joinRetryDelay = backoff + random(LORA_JOIN_BACKOFF);
+            this->joinRetryStart = millis();
+        }
+        this->cmdState = LORA_AT_IDLE;
+        if (Log::enabled) {
+            Log::print((this->joinStatus == LORA_JOINED) ? F("\n\tJoin [OK]") : F("\n\tJoin [FAIL]"));
+            Log::flush();
+        }
+    }
+}
+
+/**
+ * @fn RN2483::checkTx()
+ * @brief Report the end of the pending transmission and request a frame counters save
+ *        every \ref LORA_FCNT_SAVE_INTERVAL messages (see \ref checkSave()).
+ */
+template <class Transport, class Log>
+void RN2483<Transport, Log>::checkTx() {
+    if ((this->txStatus != LORA_TX_PENDING) || (this->cmdState == LORA_AT_WAITING)) {
+        return;
+    }
+
+    uint8_t statusCode = getCmdStatus();
+    this->cmdState = LORA_AT_IDLE;
+
+    // Modem lost the OTAA session, so join again
+    if ((statusCode == LORA_STATUS_NOT_JOINED) && (this->config.auth_mode == LWOTAA)) {
+        this->joinStatus = LORA_NOT_JOINED;
+        this->joinRetryDelay = 0;
+        this->joinRetryStart = millis();
+    }
+
+    // Modem restores its frame counters on reset from the last "mac save"
+    if (++this->fcntCount >= LORA_FCNT_SAVE_INTERVAL) {
+        this->fcntCount = 0;
+        this->savePending = true;
+    }
+    this->drPending = (this->config.adr == ON);
+
+    this->endTx(statusCode);
+}
+
+/**
+ * @fn RN2483::checkSave()
+ * @brief Start the requested "mac save" when the modem is idle and end it when answered.
+ * @details The modem writes its EEPROM for up to \ref RN2483_SAVE_TIMEOUT, so the command
+ *          is not waited for (a failed save is retried on the next request).
+ */
+template <class Transport, class Log>
+void RN2483<Transport, Log>::checkSave() {
+    if (this->saveRunning) {
+        if (this->cmdState != LORA_AT_WAITING) {
+            this->saveRunning = false;
+            this->cmdState = LORA_AT_IDLE;
+        }
+    } else if (this->savePending && !isBusy()) {
+        if (beginCmd("mac save", RN2483_SAVE_TIMEOUT) == LORA_STATUS_OK) {
+            this->savePending = false;
+            this->saveRunning = true;
+        }
+    }
+}
+
+/**
+ * @fn RN2483::checkDR()
+ * @brief Read the uplink datarate ("mac get dr") after a transmission when ADR is 
+ *        enabled, since the network may have changed it. Never blocks.
+ */
+template <class Transport, class Log>
+void RN2483<Transport, Log>::checkDR() {
+    if (this->drRunning) {
+        if (this->cmdState != LORA_AT_WAITING) {
+            if ((this->cmdState == LORA_AT_DONE) && isdigit(this->cmdResponse[0])) {
+                this->currentDR = (LoRaDR_e)atoi(this->cmdResponse);
+            }
+            this->drRunning = false;
+            this->cmdState = LORA_AT_IDLE;
+        }
+    } else if (this->drPending && !isBusy()) {
+        if (beginCmd("mac get dr") == LORA_STATUS_OK) {
+            this->drPending = false;
+            this->drRunning = true;
+        }
+    }
+}
+
+/**
+ * @fn RN2483::beginTxCmd(bool confirmed, uint8_t port, const char* hex, const uint8_t* buf, size_t size)
+ * @brief Send a "mac tx" command with its payload given as hex string (\p hex) or
+ *        bytes (\p buf) and mark the transmission as pending.
+ * @details The modem retries confirmed messages up to \ref LoRaConfig_t::retry times
+ *          without reporting each attempt, so the airtime of all of them is charged
+ *          when the message is sent.
+ */
+template <class Transport, class Log>
+uint8_t RN2483<Transport, Log>::beginTxCmd(bool confirmed, uint8_t port, const char* hex, const uint8_t* buf, size_t size) {
+    char cmd[20];
+
+    if (Log::enabled) {
+        Log::print(confirmed ? F("\nSending LoRa ACK hexadecimal message...") : F("\nSending LoRa noACK hexadecimal message..."));
+        Log::flush();
+    }
+    if (poll() == LORA_AT_WAITING) {
+        return LORA_STATUS_BUSY;
+    }
+
+    // Modem retries confirmed messages, so wait for all of its attempts
+    uint32_t timeout = LORA_TX_TIMEOUT;
+    if (confirmed) {
+        timeout *= (uint32_t)this->config.retry + 1;
+    }
+    snprintf(cmd, sizeof(cmd), "mac tx %s %u ", confirmed ? "cnf" : "uncnf", port);
+    this->txConfirmed = confirmed;
+    this->cmdResponse[0] = '\0';
+    this->cmdTwoLines = true;
+    this->cmdTimeout = timeout;
+    this->cmdStart = millis();
+    this->cmdState = LORA_AT_WAITING;
+    this->transport.print(cmd);
+    if (hex != NULL) {
+        this->transport.print(hex);
+    } else {
+        printHex(this->transport, buf, size);
+    }
+    this->transport.print("\r\n");
+    this->beginTx(size, confirmed);
+    if (confirmed) {
+        for (uint8_t i = 0; i < this->config.retry; i++) {
+            this->spendAirtime(size);
+        }
+    }
+
+    return LORA_STATUS_OK;
+}
+
+/**
+ * @fn RN2483::sendNoAckMsgHex(uint8_t port, String buf)
+ * @brief Send a LoRa message without ACK (unconfirmed) without waiting for its result.
+ * @param[in] port - LoRa port.
+ * @param[in] buf - hex encoded message.
+ */
+template <class Transport, class Log>
+uint8_t RN2483<Transport, Log>::sendNoAckMsgHex(uint8_t port, String buf) {
+    uint8_t statusCode = this->checkTxAllowed(buf.length() / 2);
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    return beginTxCmd(false, port, buf.c_str(), NULL, buf.length() / 2);
+}
+
+/**
+ * @fn RN2483::sendNoAckMsgHex(uint8_t port, const uint8_t* buf, size_t size)
+ * @brief Send a LoRa message without ACK (unconfirmed) without waiting for its result.
+ * @param[in] port - LoRa port.
+ * @param[in] buf - message bytes.
+ * @param[in] size - message size (in bytes).
+ */
+template <class Transport, class Log>
+uint8_t RN2483<Transport, Log>::sendNoAckMsgHex(uint8_t port, const uint8_t* buf, size_t size) {
+    uint8_t statusCode = this->checkTxAllowed(size);
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    return beginTxCmd(false, port, NULL, buf, size);
+}
+
+/**
+ * @fn RN2483::sendAckMsgHex(uint8_t port, const uint8_t* buf, size_t size)
+ * @brief Send a LoRa message with ACK (confirmed) without waiting for its result.
+ * @param[in] port - LoRa port.
+ * @param[in] buf - message bytes.
+ * @param[in] size - message size (in bytes).
+ */
+template <class Transport, class Log>
+uint8_t RN2483<Transport, Log>::sendAckMsgHex(uint8_t port, const uint8_t* buf, size_t size) {
+    uint8_t statusCode = this->checkTxAllowed(size);
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    return beginTxCmd(true, port, NULL, buf, size);
+}
+
+#endif // __RN2483_H__
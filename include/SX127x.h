@@ -0,0 +1,421 @@
+/**
+ * @file SX127x.h
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Semtech SX127x LoRaWAN backend (MCCI LMIC stack running on the MCU).
+ * @version alpha
+ * @since 17/10/2026
+ * @date 17/10/2026
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __SX127X_H__
+#define __SX127X_H__
+
+#include <Arduino.h>
+#include <lmic.h>
+#include <hal/hal.h>
+#include "LoRa.h"
+
+/**
+ * @class SX127x
+ * @brief SX127x radio driven by the LMIC LoRaWAN stack (no AT modem in between).
+ * @details Region and radio are LMIC build flags (e.g. CFG_eu868, CFG_us915, CFG_sx1276_radio),
+ *          so \ref LoRaConfig_t::baseband must match them. Pins are given by the
+ *          application in \p lmic_pins. LMIC retries OTAA joins by itself, so
+ *          \ref LoRaConfig_t::retry only applies to confirmed messages. Only class A
+ *          is supported. ABP frame counters are kept in the EEPROM slots of \ref LoRaRadio,
+ *          since LMIC starts every session at 0.
+ * @tparam Log - logging policy (\ref LoRaSerialLog or \ref LoRaNoLog).
+ */
+template <class Log>
+class SX127x : public LoRaRadio<SX127x<Log>, Log> {
+    private:
+        bool txConfirmed = false;
+        uint8_t fcntCount = 0;
+        static void onEvent(void* userData, ev_t ev);
+        void handleEvent(ev_t ev);
+        void handleTxComplete();
+        void restoreFCnt();
+        void checkFCnt();
+        dr_t getLmicDR(LoRaDR_e dr);
+        LoRaDR_e getLoRaDR(dr_t dr);
+        static void parseHex(const String& hex, uint8_t* buf, uint8_t size, bool lsbFirst);
+        uint8_t startTx(bool confirmed, uint8_t port, const uint8_t* buf, size_t size);
+
+    public:
+        uint8_t init(LoRaConfig_t config);
+        LoRaATState_e poll();
+        bool isBusy();
+        String getFWVersion();
+        void getDevEUI(uint8_t* buf);
+        void getAppEUI(uint8_t* buf);
+        void getAppKey(uint8_t* buf);
+        uint8_t sendNoAckMsgHex(uint8_t port, const uint8_t* buf, size_t size);
+        uint8_t sendAckMsgHex(uint8_t port, const uint8_t* buf, size_t size);
+};
+
+/****************************************************************************************
+ * FUNCTIONS IMPLEMENTATIONS
+ ****************************************************************************************/
+
+/**
+ * @fn SX127x::init(LoRaConfig_t config)
+ * @brief Initialize LMIC and the LoRaWAN session.
+ * @details ABP sessions are set here, OTAA joins are started here and progressed by
+ *          \ref poll().
+ * @param[in] config - struct with LoRa configuration (see \ref LoRaConfig_t).
+ * @retval status code - 0 if successful initialization or error code.
+ */
+template <class Log>
+uint8_t SX127x<Log>::init(LoRaConfig_t config) {
+    this->setConfig(config);
+
+    if (this->config.op_class != A) {
+        return LORA_STATUS_INVALID_PARAM;
+    }
+
+    if (Log::enabled) {
+        Log::print(F("\n\t\tStarting LMIC... "));
+        Log::flush();
+    }
+    os_init();
+    LMIC_reset();
+    LMIC_registerEventCb(onEvent, this);
+
+    // Sub bands only exist in US915/AU920 base bands
+    if ((this->config.baseband != EU868) && (this->config.subband >= 1) && (this->config.subband <= 8)) {
+        LMIC_selectSubBand(this->config.subband - 1);
+    }
+    LMIC_setAdrMode(this->config.adr == ON);
+    LMIC_setLinkCheckMode(0);
+    LMIC_setDrTxpow(getLmicDR(this->config.uplink_dr), 30 - (2 * (int8_t)this->config.tx_power));
+    LMIC_setClockError(MAX_CLOCK_ERROR * 1 / 100);
+
+    if (this->config.auth_mode == LWABP) {
+        uint8_t devAddr[4];
+        uint8_t nwkSKey[16];
+        uint8_t appSKey[16];
+        parseHex(this->config.dev_addr, devAddr, sizeof(devAddr), false);
+        parseHex(this->config.nwks_key, nwkSKey, sizeof(nwkSKey), false);
+        parseHex(this->config.apps_key, appSKey, sizeof(appSKey), false);
+        LMIC_setSession(0x13, ((uint32_t)devAddr[0] << 24) | ((uint32_t)devAddr[1] << 16) |
+                              ((uint32_t)devAddr[2] << 8) | devAddr[3], nwkSKey, appSKey);
+        restoreFCnt();
+        this->joinStatus = LORA_JOINED;
+    } else {
+        LMIC_startJoining();
+        this->joinStatus = LORA_JOINING;
+    }
+    if (Log::enabled) {
+        Log::print(F("[OK]"));
+        Log::flush();
+    }
+
+    return LORA_STATUS_OK;
+}
+
+/**
+ * @fn SX127x::poll()
+ * @brief Run LMIC jobs and dispatch received downlinks. Never blocks, so it can be
+ *        called on every loop() iteration.
+ * @return LoRaATState_e - always LORA_AT_IDLE (there is no AT layer).
+ */
+template <class Log>
+LoRaATState_e SX127x<Log>::poll() {
+    os_runloop_once();
+    this->callback_RX();
+
+    return LORA_AT_IDLE;
+}
+
+/**
+ * @fn SX127x::isBusy()
+ * @brief Check if LMIC is joining or has a transmission in progress.
+ */
+template <class Log>
+bool SX127x<Log>::isBusy() {
+    return (this->txStatus == LORA_TX_PENDING) || ((LMIC.opmode & (OP_TXRXPEND | OP_JOINING)) != 0);
+}
+
+/**
+ * @fn SX127x::getFWVersion()
+ * @brief Get LoRaWAN stack version.
+ */
+template <class Log>
+String SX127x<Log>::getFWVersion() {
+    String version = "LMIC ";
+    version.concat(ARDUINO_LMIC_VERSION_GET_MAJOR(ARDUINO_LMIC_VERSION));
+    version.concat(".");
+    version.concat(ARDUINO_LMIC_VERSION_GET_MINOR(ARDUINO_LMIC_VERSION));
+    version.concat(".");
+    version.concat(ARDUINO_LMIC_VERSION_GET_PATCH(ARDUINO_LMIC_VERSION));
+
+    return version;
+}
+
+/**
+ * @fn SX127x::onEvent(void* userData, ev_t ev)
+ * @brief LMIC event callback (\p userData is the driver instance).
+ */
+template <class Log>
+void SX127x<Log>::onEvent(void* userData, ev_t ev) {
+    static_cast<SX127x<Log>*>(userData)->handleEvent(ev);
+}
+
+/**
+ * @fn SX127x::handleEvent(ev_t ev)
+ * @brief Handle LMIC join and transmission events.
+ */
+template <class Log>
+void SX127x<Log>::handleEvent(ev_t ev) {
+    switch (ev) {
+        case EV_JOINING:
+            this->joinStatus = LORA_JOINING;
+            break;
+        case EV_JOINED:
+            // LMIC turns link checks on after a join
+            LMIC_setLinkCheckMode(0);
+            this->joinStatus = LORA_JOINED;
+            if (Log::enabled) {
+                Log::print(F("\n\tJoin [OK]"));
+                Log::flush();
+            }
+            break;
+        case EV_JOIN_FAILED:
+        case EV_REJOIN_FAILED:
+            if (Log::enabled) {
+                Log::print(F("\n\tJoin [FAIL]"));
+                Log::flush();
+            }
+            // LMIC paces the next attempts by itself (duty cycle and join backoff)
+            this->joinStatus = LORA_JOINING;
+            LMIC_startJoining();
+            break;
+        case EV_RESET:
+        case EV_LINK_DEAD:
+            if (this->config.auth_mode == LWOTAA) {
+                this->joinStatus = LORA_JOINING;
+                LMIC_startJoining();
+            }
+            break;
+        case EV_TXCOMPLETE:
+            handleTxComplete();
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @fn SX127x::handleTxComplete()
+ * @brief Collect the downlink and link statistics of the transmission that just ended
+ *        and report its result.
+ */
+template <class Log>
+void SX127x<Log>::handleTxComplete() {
+    if (this->txStatus != LORA_TX_PENDING) {
+        return;
+    }
+
+    uint8_t statusCode = LORA_STATUS_OK;
+    if (this->txConfirmed && ((LMIC.txrxFlags & TXRX_ACK) == 0)) {
+        statusCode = LORA_STATUS_NO_ACK;
+    }
+
+    // Radio statistics are only valid if something was received
+    if ((LMIC.txrxFlags & (TXRX_ACK | TXRX_DNW1 | TXRX_DNW2)) != 0) {
+        this->linkCurrent.rssi = LMIC.rssi - RSSI_OFF;
+        this->linkCurrent.snr = LMIC.snr / 4;
+        this->linkCurrent.flags |= LORA_LINK_RSSI;
+    }
+    if ((LMIC.dataLen > 0) && ((LMIC.txrxFlags & TXRX_PORT) != 0)) {
+        this->receiveDownlink(LMIC.frame[LMIC.dataBeg - 1], LMIC.frame + LMIC.dataBeg, LMIC.dataLen);
+    }
+
+    // ADR may have changed the datarate of the next uplinks
+    this->currentDR = getLoRaDR(LMIC.datarate);
+    checkFCnt();
+    this->endTx(statusCode);
+}
+
+/**
+ * @fn SX127x::restoreFCnt()
+ * @brief Restore the frame counters of the ABP session saved in EEPROM.
+ * @details Counters are saved every \ref LORA_FCNT_SAVE_INTERVAL messages, so the uplink
+ *          counter is restored that far ahead and saved again at once (another reset
+ *          before the next save must not reuse the same counters). A new configuration
+ *          starts a new session with counters at 0.
+ */
+template <class Log>
+void SX127x<Log>::restoreFCnt() {
+    LoRaFCntRecord_t record;
+
+    this->fcntCount = 0;
+    if (!this->isConfigSaved() || (this->loadFCnt(record) < 0)) {
+        this->saveConfigRecord(true);
+        this->saveFCnt(0, 0);
+        return;
+    }
+
+    if (Log::enabled) {
+        Log::print(F("\n\t\tRestoring LoRa frame counters... "));
+        Log::flush();
+    }
+    LMIC.seqnoUp = record.uplink + LORA_FCNT_SAVE_INTERVAL;
+    LMIC.seqnoDn = record.downlink;
+    this->saveFCnt(LMIC.seqnoUp, LMIC.seqnoDn);
+    if (Log::enabled) {
+        Log::print(F("[OK]"));
+        Log::flush();
+    }
+}
+
+/**
+ * @fn SX127x::checkFCnt()
+ * @brief Save the ABP frame counters every \ref LORA_FCNT_SAVE_INTERVAL messages.
+ */
+template <class Log>
+void SX127x<Log>::checkFCnt() {
+    if (this->config.auth_mode != LWABP) {
+        return;
+    }
+    if (++this->fcntCount >= LORA_FCNT_SAVE_INTERVAL) {
+        this->fcntCount = 0;
+        this->saveFCnt(LMIC.seqnoUp, LMIC.seqnoDn);
+    }
+}
+
+/**
+ * @fn SX127x::startTx(bool confirmed, uint8_t port, const uint8_t* buf, size_t size)
+ * @brief Queue a message in LMIC (sent by \ref poll()).
+ */
+template <class Log>
+uint8_t SX127x<Log>::startTx(bool confirmed, uint8_t port, const uint8_t* buf, size_t size) {
+    uint8_t statusCode = this->checkTxAllowed(size);
+    if (statusCode != LORA_STATUS_OK) {
+        return statusCode;
+    }
+
+    if (Log::enabled) {
+        Log::print(confirmed ? F("\nSending LoRa ACK hexadecimal message...") : F("\nSending LoRa noACK hexadecimal message..."));
+        Log::flush();
+    }
+    // LMIC retries confirmed messages by itself
+    if (LMIC_setTxData2(port, (xref2u1_t)buf, size, confirmed) != 0) {
+        return LORA_STATUS_AT_ERROR;
+    }
+    this->txConfirmed = confirmed;
+    this->beginTx(size, confirmed);
+
+    return LORA_STATUS_OK;
+}
+
+/**
+ * @fn SX127x::sendNoAckMsgHex(uint8_t port, const uint8_t* buf, size_t size)
+ * @brief Send a LoRa message without ACK (unconfirmed) without waiting for its result.
+ */
+template <class Log>
+uint8_t SX127x<Log>::sendNoAckMsgHex(uint8_t port, const uint8_t* buf, size_t size) {
+    return startTx(false, port, buf, size);
+}
+
+/**
+ * @fn SX127x::sendAckMsgHex(uint8_t port, const uint8_t* buf, size_t size)
+ * @brief Send a LoRa message with ACK (confirmed) without waiting for its result.
+ */
+template <class Log>
+uint8_t SX127x<Log>::sendAckMsgHex(uint8_t port, const uint8_t* buf, size_t size) {
+    return startTx(true, port, buf, size);
+}
+
+/**
+ * @fn SX127x::getLmicDR(LoRaDR_e dr)
+ * @brief Convert a datarate (numbered as in \ref LoRaDR_e) to the datarate of the LMIC region.
+ * @details LMIC AU915 follows the regional parameters where DR0 is SF12/125KHz, while
+ *          \ref LoRaDR_e numbers AU920 like US915 (DR0 is SF10/125KHz, DR4 is SF8/500KHz).
+ *          EU868 and US915 datarates are the same in both.
+ */
+template <class Log>
+dr_t SX127x<Log>::getLmicDR(LoRaDR_e dr) {
+    if (this->config.baseband == AU920) {
+        if (dr <= DR3) {
+            return (dr_t)(dr + 2);
+        }
+        if (dr == DR4) {
+            return 6;
+        }
+    }
+
+    return (dr_t)dr;
+}
+
+/**
+ * @fn SX127x::getLoRaDR(dr_t dr)
+ * @brief Convert a datarate of the LMIC region to \ref LoRaDR_e (see \ref getLmicDR()).
+ * @details AU915 SF12 and SF11 have no \ref LoRaDR_e value, so they are reported as 
+ *          DR0 (the smallest payload).
+ */
+template <class Log>
+LoRaDR_e SX127x<Log>::getLoRaDR(dr_t dr) {
+    if (this->config.baseband == AU920) {
+        if (dr < 2) {
+            return DR0;
+        }
+        if (dr <= 5) {
+            return (LoRaDR_e)(dr - 2);
+        }
+        if (dr == 6) {
+            return DR4;
+        }
+    }
+
+    return (LoRaDR_e)dr;
+}
+
+/**
+ * @fn SX127x::parseHex(const String& hex, uint8_t* buf, uint8_t size, bool lsbFirst)
+ * @brief Convert a hex string (MSB first, as printed by network servers) to bytes.
+ * @param[in] lsbFirst - store the bytes in reverse order (LMIC expects EUIs LSB first).
+ */
+template <class Log>
+void SX127x<Log>::parseHex(const String& hex, uint8_t* buf, uint8_t size, bool lsbFirst) {
+    for (uint8_t i = 0; i < size; i++) {
+        char hexByte[3] = {hex.charAt(2 * i), hex.charAt((2 * i) + 1), '\0'};
+        buf[lsbFirst ? (size - 1 - i) : i] = (uint8_t)strtoul(hexByte, NULL, 16);
+    }
+}
+
+/**
+ * @fn SX127x::getDevEUI(uint8_t* buf)
+ * @brief Get DevEUI in LMIC format (used by os_getDevEui()).
+ */
+template <class Log>
+void SX127x<Log>::getDevEUI(uint8_t* buf) {
+    parseHex(this->config.dev_eui, buf, 8, true);
+}
+
+/**
+ * @fn SX127x::getAppEUI(uint8_t* buf)
+ * @brief Get AppEUI in LMIC format (used by os_getArtEui()).
+ */
+template <class Log>
+void SX127x<Log>::getAppEUI(uint8_t* buf) {
+    parseHex(this->config.app_eui, buf, 8, true);
+}
+
+/**
+ * @fn SX127x::getAppKey(uint8_t* buf)
+ * @brief Get AppKey in LMIC format (used by os_getDevKey()).
+ */
+template <class Log>
+void SX127x<Log>::getAppKey(uint8_t* buf) {
+    parseHex(this->config.app_key, buf, 16, false);
+}
+
+#endif // __SX127X_H__
@@ -0,0 +1,85 @@
+/**
+ * @file UplinkQueue.h
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Store-and-forward queue of uplink frames.
+ * @version alpha
+ * @since 2026-10-17
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __UPLINK_QUEUE_H__
+#define __UPLINK_QUEUE_H__
+
+#include <Arduino.h>
+
+/**
+ * \def UPLINK_FRAME_SIZE
+ * Maximum size (in bytes) of a queued frame payload.
+ */
+#define UPLINK_FRAME_SIZE           32
+
+/**
+ * \def UPLINK_QUEUE_RAM_SLOTS
+ * Number of frames held in SRAM (newest frames), older frames are spilled to EEPROM.
+ */
+#define UPLINK_QUEUE_RAM_SLOTS      4
+
+/**
+ * @struct UplinkFrame_t
+ * @brief Queued uplink frame.
+ */
+struct UplinkFrame_t {
+    uint16_t window;                    /**< Transmission window index of the frame. */
+    uint32_t timestamp;                 /**< Time (millis()) the frame was queued. */
+    uint8_t port;                       /**< LoRa port of the frame. */
+    uint8_t size;                       /**< Payload size (in bytes). */
+    uint8_t data[UPLINK_FRAME_SIZE];    /**< Payload. */
+};
+
+/**
+ * @struct UplinkSlot_t
+ * @brief EEPROM spill ring slot. Slots of the ring hold consecutive sequence numbers, 
+ *        so the ring is rebuilt after a reset.
+ */
+struct UplinkSlot_t {
+    uint16_t seq;                       /**< Sequence number of the spilled frame. */
+    UplinkFrame_t frame;                /**< Spilled frame. */
+    uint16_t crc;                       /**< CRC-16/CCITT of the previous fields. */
+};
+
+class UplinkQueue {
+    private:
+        UplinkFrame_t ram[UPLINK_QUEUE_RAM_SLOTS];
+        uint8_t ramHead = 0;
+        uint8_t ramCount = 0;
+        const uint16_t EEPROM_ADDR;
+        const uint8_t EEPROM_SLOTS;
+        uint8_t eepromHead = 0;
+        uint8_t eepromCount = 0;
+        uint16_t eepromSeq = 0;         // Sequence number of the oldest spilled frame
+        uint8_t restoredCount = 0;      // Spilled frames restored from a previous run
+        const uint32_t MAX_AGE;
+        void restore();
+        uint16_t getSlotAddr(uint8_t slot) const;
+        bool loadSlot(uint8_t slot, UplinkSlot_t& record) const;
+        void getOldest(UplinkFrame_t& frame) const;
+        void dropOldest();
+        void spill();
+
+    public:
+        UplinkQueue(uint16_t eepromAddr, uint8_t eepromSlots, uint32_t maxAge);
+
+        bool push(uint8_t port, uint16_t window, const uint8_t* buf, uint8_t size);
+        bool peek(UplinkFrame_t& frame);
+        void pop();
+        uint8_t count() const;
+};
+
+#endif // __UPLINK_QUEUE_H__
@@ -2,6 +2,8 @@
 #define __ATS_02_SETUP_H__
 
 #include <Arduino.h>
+#include "PayloadCodec.h"
+#include "LoRa.h"
 
 enum power_supply_e {BATTERY, POWER_LINE};
 const char* power_supply_str[] = {"Battery", "Power Line"};
@@ -117,11 +119,26 @@ const char* power_supply_str[] = {"Battery", "Power Line"};
  */
 #define MCU_BOARD               "MEGA2560"
 
+/**
+ * \def LORA_RADIO_RHF76 
+ * LoRaWAN radio backend: RHF76-052 AT modem (LORA_RADIO_RHF76), RN2483/RN2903 AT 
+ * modem (LORA_RADIO_RN2483) or SX127x radio driven by LMIC (LORA_RADIO_SX127X).
+ */
+#define LORA_RADIO_RHF76
+// #define LORA_RADIO_RN2483
+// #define LORA_RADIO_SX127X
+
 /**
  * \def COMM_IF 
  * Communication interface.
  */
-#define COMM_IF                 "LoRaWAN - RHF76-052"
+#if defined(LORA_RADIO_RN2483)
+    #define COMM_IF             "LoRaWAN - RN2483"
+#elif defined(LORA_RADIO_SX127X)
+    #define COMM_IF             "LoRaWAN - SX127x (LMIC)"
+#else
+    #define COMM_IF             "LoRaWAN - RHF76-052"
+#endif
 
 /**
  * \def FW_VERSION 
@@ -178,6 +195,12 @@ const char* power_supply_str[] = {"Battery", "Power Line"};
  */
 #define SERIAL_LORA     Serial2
 
+/**
+ * \def LORA_BAUDRATE 
+ * Baud rate negotiated with the LoRaWAN modem (falls back to 9600 bps).
+ */
+#define LORA_BAUDRATE   115200
+
 /*******************************************************
  *                   SYSTEM PINOUT
  *******************************************************/
@@ -291,15 +314,144 @@ const char* power_supply_str[] = {"Battery", "Power Line"};
     #define PLUVIOMETER_PIN             3
 #endif
 
+#ifdef LORA_RADIO_SX127X
+    /**
+    * \def LORA_NSS_PIN 
+    * SX127x SPI chip select pin.
+    */
+    #define LORA_NSS_PIN                53
+
+    /**
+    * \def LORA_RST_PIN 
+    * SX127x reset pin.
+    */
+    #define LORA_RST_PIN                49
+
+    /**
+    * \def LORA_DIO0_PIN 
+    * SX127x DIO0 pin (TX/RX done).
+    */
+    #define LORA_DIO0_PIN               47
+
+    /**
+    * \def LORA_DIO1_PIN 
+    * SX127x DIO1 pin (RX timeout).
+    */
+    #define LORA_DIO1_PIN               45
+#endif
+
 /*******************************************************
  *                  SYSTEM PARAMETERS
  *******************************************************/
 const unsigned long systemPeriod = 1000;                        /**< System run period (in ms). */
-const unsigned long samplingPeriod = 60 * systemPeriod;         /**< Sampling period (in ms). */
-const unsigned long txPeriod = 5 * samplingPeriod;              /**< Transmission period (in ms). */
+const unsigned long defaultSamplingPeriod = 60 * systemPeriod;  /**< Default sampling period (in ms), may be changed by downlink. */
+const unsigned long defaultTxPeriod = 5 * defaultSamplingPeriod;/**< Default transmission period (in ms), may be changed by downlink. */
 const float pi = 3.1415926;                                     /**< PI used in anemometer computation. */
 const float anemometer_radius = 0.147;                          /**< Anemometer radius (in m). */
 const unsigned long error_reset_period = 60 * systemPeriod;      /**< Error reset period (in ms). */
+const uint8_t remote_cmd_port = 10;                             /**< LoRa port of remote command downlinks. */
+const uint8_t backfill_port = 2;                                /**< LoRa port of queued (backfilled) uplinks. */
+const unsigned long backfill_period = 30 * systemPeriod;        /**< Minimum period (in ms) between backfilled uplinks. */
+const unsigned long queue_max_age = 86400000UL;                  /**< Queued uplinks older than it (in ms) are dropped. */
+const uint8_t queue_eeprom_slots = 48;                          /**< Queued uplinks spilled to EEPROM. */
+
+/*******************************************************
+ *                  UPLINK CHANNELS
+ *******************************************************/
+/**
+ * @struct uplink_channel_t
+ * @brief Uplink channel: frames with its own port, rate and field set.
+ * @details Each field should belong to a single channel, since its samples are 
+ *          cleared when the channel frame is built. Window statistics are sent only
+ *          for averaged fields (not for wind direction, rain, link health or timestamp).
+ */
+struct uplink_channel_t {
+    uint8_t port;       /**< LoRa port. */
+    uint8_t every;      /**< Send a frame every N transmission periods. */
+    uint16_t fields;    /**< Fields of the frame (see \ref uplink_field_e). */
+    uint8_t keyframe_every; /**< Send a keyframe every N frames and delta frames between them (0 = no delta frames). */
+    uint16_t stats[STAT_COUNT]; /**< Fields sent with their window minimum, maximum and standard deviation (see \ref payload_stat_e). */
+    uint8_t heartbeat_every;    /**< Report by exception: skip frames without fields out of their deadband, but send one at least every N frames (0 = always send). */
+};
+
+constexpr uplink_channel_t uplink_channels[] = {                     /**< Uplink channels (at most 8). */
+    {3, 1, FIELD_WIND_DIR | FIELD_WIND_SPEED | FIELD_RAIN | FIELD_TIMESTAMP, 0,             /* Weather (fast) */
+           {0, FIELD_WIND_SPEED, 0}, 6},                                                    /* Gusts, heartbeat every 30 min */
+    {4, 6, FIELD_AIR_TEMP | FIELD_AIR_HUMID | FIELD_SOIL_TEMP | FIELD_SOIL_MOISTURE | 
+           FIELD_LEAF_MOISTURE | FIELD_UV | FIELD_LIGHT | FIELD_PRESSURE | 
+           FIELD_DEV_TEMP | FIELD_POWER_SUPPLY | FIELD_TIMESTAMP, 12,                        /* Environment and power (slow) */
+           {FIELD_AIR_TEMP | FIELD_AIR_HUMID, FIELD_AIR_TEMP, 0}, 4}                        /* Temperature range, lowest humidity, heartbeat every 2 h */
+};
+const uint8_t uplink_channels_count = sizeof(uplink_channels) / sizeof(uplink_channels[0]);
+const unsigned long uplink_gap = 15 * systemPeriod;             /**< Minimum time (in ms) between frames of different channels. */
+
+/**
+ * \def DEADBAND_OFF
+ * Deadband threshold that is never exceeded.
+ */
+#define DEADBAND_OFF            0xFFFF
+
+/**
+ * @struct field_deadband_t
+ * @brief Report by exception deadband of a field (see \ref uplink_channel_t::heartbeat_every).
+ * @details A field changed when its raw value (or window minimum or maximum) differs 
+ *          from the value in the last frame sent by more than \p absolute raw units, or 
+ *          by more than \p relative percent of that value. Fields that appear or 
+ *          disappear always changed, and so does any rain.
+ */
+struct field_deadband_t {
+    uint16_t absolute;  /**< Absolute threshold (in raw units, see \ref field_schema). */
+    uint8_t relative;   /**< Relative threshold (in %, 0 = none). */
+};
+
+constexpr field_deadband_t field_deadbands[FIELD_COUNT] = {    /**< Deadbands, indexed by field bit position. */
+    {5, 0},                 /* FIELD_AIR_TEMP: 0.5 C */
+    {30, 0},                /* FIELD_AIR_HUMID: 3.0 % */
+    {5, 0},                 /* FIELD_SOIL_TEMP: 0.5 C */
+    {3, 0},                 /* FIELD_SOIL_MOISTURE: 3 % */
+    {5, 0},                 /* FIELD_LEAF_MOISTURE: 5 % */
+    {1, 0},                 /* FIELD_UV: 1 */
+    {DEADBAND_OFF, 25},     /* FIELD_LIGHT: 25 % */
+    {DEADBAND_OFF, 0},      /* FIELD_WIND_DIR: follows wind speed */
+    {20, 25},               /* FIELD_WIND_SPEED: 2.0 Km/h or 25 % */
+    {DEADBAND_OFF, 0},      /* FIELD_RAIN: any turn around */
+    {10, 0},                /* FIELD_PRESSURE: 1.0 hPa */
+    {20, 0},                /* FIELD_DEV_TEMP: 2.0 C */
+    {20, 0},                /* FIELD_POWER_SUPPLY: 0.20 V */
+    {DEADBAND_OFF, 0},      /* FIELD_LINK_HEALTH: never */
+    {DEADBAND_OFF, 0}       /* FIELD_TIMESTAMP: never */
+};
+
+/*******************************************************
+ *                  HISTORY BATCHES
+ *******************************************************/
+const uint8_t history_port = 5;                                 /**< LoRa port of history fragments (0 disables history batches). */
+const uint16_t history_fields = FIELD_WIND_DIR | FIELD_WIND_SPEED | FIELD_RAIN;    /**< Fields of each history sample (see \ref uplink_field_e). */
+const uint8_t history_samples = 15;                             /**< Samples of a history batch. */
+const uint8_t history_block_size = 160;                         /**< Maximum size (in bytes) of a history batch. */
+const uint8_t history_max_failures = 3;                         /**< Consecutive failures of a fragment that drop its history batch. */
+const bool history_parity = true;                               /**< Send a parity fragment, so a batch survives one lost fragment. */
+
+/*******************************************************
+ *                     EEPROM MAP
+ *******************************************************/
+/**
+ * \def EEPROM_LORA_ADDR
+ * EEPROM address of LoRa modem persistent data (LORA_EEPROM_SIZE bytes).
+ */
+#define EEPROM_LORA_ADDR                0
+
+/**
+ * \def EEPROM_PERIODS_ADDR
+ * EEPROM address of sampling and transmission periods.
+ */
+#define EEPROM_PERIODS_ADDR             128
+
+/**
+ * \def EEPROM_QUEUE_ADDR
+ * EEPROM address of the uplink queue spill ring (queue_eeprom_slots slots of UplinkSlot_t).
+ */
+#define EEPROM_QUEUE_ADDR               256
 
 /*********************************************
  *             TTN PARAMETERS
@@ -310,5 +462,18 @@ const char* app_key = "00000000000000000000000000000000";       /**< Application
 const char* apps_key = "00000000000000000000000000000000";      /**< Application Session Key for TTN network. */
 const char* nwks_key = "00000000000000000000000000000000";      /**< Network Session Key for TTN network. */ 
 const char* dev_addr = "00000000";                              /**< Device address for TTN network. */
+const LoRaBaseBand_e lora_baseband = AU920;                     /**< LoRaWAN base band. */
+const LoRaDR_e lora_uplink_dr = DR1;                            /**< Uplink datarate (initial one with ADR), uplink channel frames must fit its payload. */
+const uint8_t retry = 3;                                        /**< Confirmed uplink retry times. */
+const uint16_t retry_backoff = 5000;                            /**< Delay before first confirmed uplink retry (in ms). */
+// Default channels send up to 336 uplinks a day: 3 confirmations, 2 link checks, 4 
+// confirmed keyframes and 1 clock synchronization request 10 downlinks
+const uint8_t downlink_budget = 10;                             /**< Downlinks requested per airtime_window (TTN fair use policy, 0 = unlimited). */
+const uint8_t confirm_every = 112;                              /**< Confirm one of every N uplinks (0 = never), while downlink_budget allows it. */
+const uint8_t link_check_every = 168;                           /**< Request a link check with one of every N uplinks (0 = never), while downlink_budget allows it. */
+const uint32_t time_sync_period = 86400000UL;                   /**< Clock synchronization period (in ms, 0 = never). */
+const uint32_t airtime_budget = 30000;                          /**< Uplink airtime budget (in ms) per window (TTN fair use policy). */
+const uint32_t airtime_window = 86400000UL;                     /**< Airtime budget window (in ms). */
+const bool lora_low_power = (POWER_SUPPLY == BATTERY);          /**< Put LoRa modem in low power mode between uplinks. */
 
 #endif // #ifndef __ATS_02_SETUP_H__
\ No newline at end of file
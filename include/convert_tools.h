@@ -4,7 +4,7 @@
  * @brief Conversion library.
  * @version 0.1.0
  * @since 2021-09-21 
- * @date 2021-09-21
+ * @date 2026-10-17
  * 
  * @copyright Copyright (c) 2021 - Robson Costa\n
  * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>). 
@@ -18,15 +18,25 @@
 #define  __CONVERT_TOOLS_H__
 
 #include <Arduino.h>
+#include "FixedPoint.h"
 
 /*******************************************************
  *                FUNCTIONS PROTOTYPES
  *******************************************************/
 uint16_t float2int15(float value, uint8_t decimal);
 uint16_t float2uint16(float value, uint8_t decimal);
+constexpr char hexDigit(uint8_t nibble);
+size_t bytes2hex(const uint8_t* buf, size_t size, char* hex);
+size_t short2hexLE(uint16_t value, char* hex);
+size_t short2hexBE(uint16_t value, char* hex);
+size_t long2hexLE(uint32_t value, char* hex);
+size_t long2hexBE(uint32_t value, char* hex);
+template <class Output> size_t printHex(Output& out, const uint8_t* buf, size_t size);
 String byte2hex(uint8_t value);
 String short2hex(uint16_t value);
 String long2hex(uint32_t value);
+uint8_t short2bytes(uint16_t value, uint8_t* buf);
+uint16_t crc16(uint16_t crc, const uint8_t* buf, size_t size);
 
 
 /*******************************************************
@@ -35,16 +45,17 @@ String long2hex(uint32_t value);
 
 /**
  * @fn float2int15
- * @brief Convert float to INT_15.
+ * @brief Convert float to INT_15 (rounded, out of range values are limited to the range).
  * @details 16th bit will be signal and from 15th to 1st bit will be number.
- *          Range: decimal = 0 (-32768 <-> 32768)
- *                 decimal = 1 (-3276.8 <-> 3276.8)
- *                 decimal = 2 (-327.68 <-> 327.68)
+ *          Range: decimal = 0 (-32767 <-> 32767)
+ *                 decimal = 1 (-3276.7 <-> 3276.7)
+ *                 decimal = 2 (-327.67 <-> 327.67)
+ *          New fields should use \ref to_fixed() (two's complement) instead.
  * @param[in] value - float value.
  * @param[in] decimal - decimal digits.
  * @return uint16_t - Converted value.
  */ 
-uint16_t float2int15(float value, uint8_t decimal) {
+inline uint16_t float2int15(float value, uint8_t decimal) {
     uint16_t converted = 0;
     float aux = value;
     
@@ -53,11 +64,11 @@ uint16_t float2int15(float value, uint8_t decimal) {
     }
 
     if (decimal == 0) {
-        converted = (uint16_t)aux;
+        converted = to_fixed<15, 1>(aux);
     } else if (decimal == 1) {
-        converted = (uint16_t)(aux * 10);
+        converted = to_fixed<15, 10>(aux);
     } else if (decimal == 2) {
-        converted = (uint16_t)(aux * 100);
+        converted = to_fixed<15, 100>(aux);
     }
     
     if (value < 0) {        
@@ -69,7 +80,7 @@ uint16_t float2int15(float value, uint8_t decimal) {
 
 /**
  * @fn float2uint16
- * @brief Convert float to UINT_16.
+ * @brief Convert float to UINT_16 (rounded, out of range values are limited to the range).
  * @details Range: decimal = 0 (0 <-> 65535)
  *                 decimal = 1 (0 <-> 6553.5)
  *                 decimal = 2 (0 <-> 655.35)
@@ -78,85 +89,178 @@ uint16_t float2int15(float value, uint8_t decimal) {
  * @param[in] decimal - decimal digits.
  * @return uint16_t - Converted value.
  */ 
-uint16_t float2uint16(float value, uint8_t decimal) {
+inline uint16_t float2uint16(float value, uint8_t decimal) {
     uint16_t converted = 0;
-    float aux = value;
-
-    if (value < 0) {
-        aux = aux * -1;        
-    }
 
     if (decimal == 0) {
-        converted = (uint16_t)aux;
+        converted = to_fixed<16, 1>(value);
     } else if (decimal == 1) {
-        converted = (uint16_t)(aux * 10);
+        converted = to_fixed<16, 10>(value);
     } else if (decimal == 2) {
-        converted = (uint16_t)(aux * 100);
-    }        
+        converted = to_fixed<16, 100>(value);
+    } else if (decimal == 3) {
+        converted = to_fixed<16, 1000>(value);
+    }
 
     return converted;
 }
 
-String byte2hex(uint8_t value) {
-    String hex = "";
+/**
+ * @fn hexDigit
+ * @brief Get the lower case hex digit of a nibble.
+ * @param[in] nibble - value (only the 4 lower bits are used).
+ * @return char - hex digit.
+ */
+constexpr char hexDigit(uint8_t nibble) {
+    return "0123456789abcdef"[nibble & 0x0F];
+}
 
-    if (value <= 0xF) {
-        hex.concat("0");
+/**
+ * @fn bytes2hex
+ * @brief Write bytes as hex string (2 digits per byte, in buffer order).
+ * @param[in] buf - bytes to be encoded.
+ * @param[in] size - number of bytes.
+ * @param[out] hex - destination buffer (at least 2 * size + 1 chars, null terminated).
+ * @return size_t - number of digits written.
+ */
+inline size_t bytes2hex(const uint8_t* buf, size_t size, char* hex) {
+    for (size_t i = 0; i < size; i++) {
+        hex[2 * i] = hexDigit(buf[i] >> 4);
+        hex[2 * i + 1] = hexDigit(buf[i]);
     }
-    hex.concat(String(value, HEX));
+    hex[2 * size] = '\0';
 
-    return hex;    
+    return 2 * size;
 }
 
-String short2hex(uint16_t value) {
-    byte low = 0;
-    byte high = 0;
-    String hex = "";
+/**
+ * @fn short2hexLE
+ * @brief Write UINT_16 as hex string, low byte first (4 digits and null terminator).
+ */
+inline size_t short2hexLE(uint16_t value, char* hex) {
+    uint8_t bytes[2] = {lowByte(value), highByte(value)};
 
-    low = lowByte(value);
-    if (low <= 0xF) {
-        hex.concat("0");
-    }
-    hex.concat(String(low, HEX));
+    return bytes2hex(bytes, sizeof(bytes), hex);
+}
 
-    high = highByte(value);
-    if (high <= 0xF) {
-        hex.concat("0");
-    }
-    hex.concat(String(high, HEX));
+/**
+ * @fn short2hexBE
+ * @brief Write UINT_16 as hex string, high byte first (4 digits and null terminator).
+ */
+inline size_t short2hexBE(uint16_t value, char* hex) {
+    uint8_t bytes[2] = {highByte(value), lowByte(value)};
 
-    return hex;
+    return bytes2hex(bytes, sizeof(bytes), hex);
 }
 
-String long2hex(uint32_t value) {
-    String hex = "";
-    byte aux = 0;
+/**
+ * @fn long2hexLE
+ * @brief Write UINT_32 as hex string, lowest byte first (8 digits and null terminator).
+ */
+inline size_t long2hexLE(uint32_t value, char* hex) {
+    uint8_t bytes[4] = {(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
 
-    aux = (byte)((value & 0xFF000000) >> 24);
-    if (aux <= 0xF) {
-        hex.concat("0");
-    }
-    hex.concat(String(aux, HEX));
+    return bytes2hex(bytes, sizeof(bytes), hex);
+}
 
-    aux = (byte)((value & 0x00FF0000) >> 16);
-    if (aux <= 0xF) {
-        hex.concat("0");
-    }
-    hex.concat(String(aux, HEX));
+/**
+ * @fn long2hexBE
+ * @brief Write UINT_32 as hex string, highest byte first (8 digits and null terminator).
+ */
+inline size_t long2hexBE(uint32_t value, char* hex) {
+    uint8_t bytes[4] = {(uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value};
 
-    aux = (byte)((value & 0x0000FF00) >> 8);
-    if (aux <= 0xF) {
-        hex.concat("0");
+    return bytes2hex(bytes, sizeof(bytes), hex);
+}
+
+/**
+ * @fn printHex
+ * @brief Write bytes as hex string (2 digits per byte, in buffer order) straight 
+ *        to an output, without building the string.
+ * @tparam Output - any class with write(uint8_t) (e.g. Print, HardwareSerial).
+ * @param[in] out - output.
+ * @param[in] buf - bytes to be encoded.
+ * @param[in] size - number of bytes.
+ * @return size_t - number of digits written.
+ */
+template <class Output>
+size_t printHex(Output& out, const uint8_t* buf, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        out.write(hexDigit(buf[i] >> 4));
+        out.write(hexDigit(buf[i]));
     }
-    hex.concat(String(aux, HEX));
 
-    aux = (byte)((value & 0x000000FF));
-    if (aux <= 0xF) {
-        hex.concat("0");
+    return 2 * size;
+}
+
+/**
+ * @fn byte2hex
+ * @brief Convert UINT_8 to hex string (2 digits).
+ * @details Prefer \ref bytes2hex() or \ref printHex(), which do not allocate a String.
+ */
+inline String byte2hex(uint8_t value) {
+    char hex[3];
+
+    bytes2hex(&value, 1, hex);
+
+    return String(hex);
+}
+
+/**
+ * @fn short2hex
+ * @brief Convert UINT_16 to hex string, low byte first (see \ref short2hexLE()).
+ */
+inline String short2hex(uint16_t value) {
+    char hex[5];
+
+    short2hexLE(value, hex);
+
+    return String(hex);
+}
+
+/**
+ * @fn long2hex
+ * @brief Convert UINT_32 to hex string, highest byte first (see \ref long2hexBE()).
+ */
+inline String long2hex(uint32_t value) {
+    char hex[9];
+
+    long2hexBE(value, hex);
+
+    return String(hex);
+}
+
+/**
+ * @fn short2bytes
+ * @brief Write UINT_16 in a byte buffer (low byte first, same order of short2hex).
+ * @param[in] value - value to be written.
+ * @param[out] buf - destination buffer (at least 2 bytes).
+ * @return uint8_t - number of bytes written.
+ */ 
+inline uint8_t short2bytes(uint16_t value, uint8_t* buf) {
+    buf[0] = lowByte(value);
+    buf[1] = highByte(value);
+
+    return 2;
+}
+
+/**
+ * @fn crc16
+ * @brief Update a CRC-16/CCITT (polynomial 0x1021) with a buffer.
+ * @param[in] crc - current CRC (0xFFFF to start a new one).
+ * @param[in] buf - bytes to be added.
+ * @param[in] size - number of bytes.
+ * @return uint16_t - updated CRC.
+ */
+inline uint16_t crc16(uint16_t crc, const uint8_t* buf, size_t size) {
+    while (size--) {
+        crc ^= (uint16_t)(*buf++) << 8;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
     }
-    hex.concat(String(aux, HEX));
 
-    return hex;
+    return crc;
 }
 
 #endif //  __CONVERT_TOOLS_H__
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include "UplinkQueue.h"
+#include <EEPROM.h>
+#include "convert_tools.h"
+
+/**
+ * @fn UplinkQueue::UplinkQueue(uint16_t eepromAddr, uint8_t eepromSlots, uint32_t maxAge)
+ * @brief Bounded FIFO of uplink frames waiting to be sent.
+ * @details Newest frames are kept in SRAM and the oldest ones are spilled to an EEPROM 
+ *          ring, so EEPROM is only written while frames are piling up. When the queue 
+ *          is full or frames are older than \p maxAge, the oldest frames are dropped first.
+ *          Spilled frames survive a reset (see \ref restore()), SRAM frames do not.
+ * @param[in] eepromAddr - EEPROM address of the spill ring.
+ * @param[in] eepromSlots - number of frames in the spill ring (0 = SRAM only).
+ * @param[in] maxAge - maximum age (in ms) of a queued frame (0 = no limit).
+ */
+UplinkQueue::UplinkQueue(uint16_t eepromAddr, uint8_t eepromSlots, uint32_t maxAge) : 
+    EEPROM_ADDR(eepromAddr), EEPROM_SLOTS(eepromSlots), MAX_AGE(maxAge) {
+    restore();
+}
+
+/**
+ * @fn UplinkQueue::push(uint8_t port, uint16_t window, const uint8_t* buf, uint8_t size)
+ * @brief Queue a frame (dropping the oldest one if the queue is full).
+ * @param[in] port - LoRa port of the frame.
+ * @param[in] window - transmission window index of the frame.
+ * @param[in] buf - pointer to payload.
+ * @param[in] size - payload size (in bytes).
+ * @retval true - frame queued.
+ * @retval false - payload is larger than \ref UPLINK_FRAME_SIZE.
+ */
+bool UplinkQueue::push(uint8_t port, uint16_t window, const uint8_t* buf, uint8_t size) {
+    if (size > UPLINK_FRAME_SIZE) {
+        return false;
+    }
+    if (this->ramCount == UPLINK_QUEUE_RAM_SLOTS) {
+        spill();
+    }
+
+    UplinkFrame_t& frame = this->ram[(this->ramHead + this->ramCount) % UPLINK_QUEUE_RAM_SLOTS];
+    frame.window = window;
+    frame.timestamp = millis();
+    frame.port = port;
+    frame.size = size;
+    memcpy(frame.data, buf, size);
+    this->ramCount++;
+
+    return true;
+}
+
+/**
+ * @fn UplinkQueue::peek(UplinkFrame_t& frame)
+ * @brief Get the oldest frame, after dropping the expired ones.
+ * @param[out] frame - oldest frame.
+ * @retval true - frame available.
+ * @retval false - queue is empty.
+ */
+bool UplinkQueue::peek(UplinkFrame_t& frame) {
+    while (count() != 0) {
+        getOldest(frame);
+        if ((this->MAX_AGE == 0) || ((millis() - frame.timestamp) <= this->MAX_AGE)) {
+            return true;
+        }
+        dropOldest();
+    }
+
+    return false;
+}
+
+/**
+ * @fn UplinkQueue::pop()
+ * @brief Remove the oldest frame (e.g. after it was sent).
+ */
+void UplinkQueue::pop() {
+    if (count() != 0) {
+        dropOldest();
+    }
+}
+
+/**
+ * @fn UplinkQueue::count()
+ * @brief Get the number of queued frames.
+ */
+uint8_t UplinkQueue::count() const {
+    return this->eepromCount + this->ramCount;
+}
+
+/**
+ * @fn UplinkQueue::restore()
+ * @brief Rebuild the spill ring from EEPROM: the newest valid slot and the valid slots 
+ *        before it with consecutive sequence numbers.
+ * @details millis() restarts with the MCU, so restored frames age from the boot.
+ */
+void UplinkQueue::restore() {
+    UplinkSlot_t record;
+    int16_t newest = -1;
+    uint16_t newestSeq = 0;
+
+    for (uint8_t i = 0; i < this->EEPROM_SLOTS; i++) {
+        if (loadSlot(i, record) && ((newest < 0) || ((int16_t)(record.seq - newestSeq) > 0))) {
+            newest = i;
+            newestSeq = record.seq;
+        }
+    }
+    if (newest < 0) {
+        return;
+    }
+
+    uint8_t slot = newest;
+    do {
+        this->eepromHead = slot;
+        this->eepromCount++;
+        slot = (slot + this->EEPROM_SLOTS - 1) % this->EEPROM_SLOTS;
+    } while ((this->eepromCount < this->EEPROM_SLOTS) && loadSlot(slot, record) && 
+             (record.seq == (uint16_t)(newestSeq - this->eepromCount)));
+    this->eepromSeq = newestSeq - this->eepromCount + 1;
+    this->restoredCount = this->eepromCount;
+}
+
+/**
+ * @fn UplinkQueue::getSlotAddr(uint8_t slot)
+ * @brief Get the EEPROM address of a spill ring slot.
+ */
+uint16_t UplinkQueue::getSlotAddr(uint8_t slot) const {
+    return this->EEPROM_ADDR + (uint16_t)slot * sizeof(UplinkSlot_t);
+}
+
+/**
+ * @fn UplinkQueue::loadSlot(uint8_t slot, UplinkSlot_t& record)
+ * @brief Read a spill ring slot and check its CRC.
+ * @retval true - slot holds a spilled frame.
+ * @retval false - slot is empty (never written or already dropped).
+ */
+bool UplinkQueue::loadSlot(uint8_t slot, UplinkSlot_t& record) const {
+    EEPROM.get(getSlotAddr(slot), record);
+
+    return record.crc == crc16(0xFFFF, (const uint8_t*)&record, offsetof(UplinkSlot_t, crc));
+}
+
+/**
+ * @fn UplinkQueue::getOldest(UplinkFrame_t& frame)
+ * @brief Read the oldest frame, spilled frames are always older than SRAM ones.
+ * @details Restored frames get timestamp 0 (queued at boot, see \ref restore()).
+ */
+void UplinkQueue::getOldest(UplinkFrame_t& frame) const {
+    if (this->eepromCount != 0) {
+        UplinkSlot_t record;
+        EEPROM.get(getSlotAddr(this->eepromHead), record);
+        frame = record.frame;
+        if (this->restoredCount != 0) {
+            frame.timestamp = 0;
+        }
+    } else {
+        frame = this->ram[this->ramHead];
+    }
+}
+
+/**
+ * @fn UplinkQueue::dropOldest()
+ * @brief Remove the oldest frame from the queue (queue must not be empty).
+ */
+void UplinkQueue::dropOldest() {
+    if (this->eepromCount != 0) {
+        // Changing only the sequence number always fails the CRC, so the slot is empty
+        EEPROM.put(getSlotAddr(this->eepromHead) + offsetof(UplinkSlot_t, seq), (uint16_t)~this->eepromSeq);
+        this->eepromHead = (this->eepromHead + 1) % this->EEPROM_SLOTS;
+        this->eepromSeq++;
+        this->eepromCount--;
+        if (this->restoredCount != 0) {
+            this->restoredCount--;
+        }
+    } else {
+        this->ramHead = (this->ramHead + 1) % UPLINK_QUEUE_RAM_SLOTS;
+        this->ramCount--;
+    }
+}
+
+/**
+ * @fn UplinkQueue::spill()
+ * @brief Move the oldest SRAM frame to the EEPROM ring (dropping the oldest spilled 
+ *        frame if the ring is full).
+ */
+void UplinkQueue::spill() {
+    if (this->EEPROM_SLOTS == 0) {
+        dropOldest();
+        return;
+    }
+    if (this->eepromCount == this->EEPROM_SLOTS) {
+        dropOldest();
+    }
+
+    UplinkSlot_t record;
+    uint8_t slot = (this->eepromHead + this->eepromCount) % this->EEPROM_SLOTS;
+    record.seq = this->eepromSeq + this->eepromCount;
+    record.frame = this->ram[this->ramHead];
+    record.crc = crc16(0xFFFF, (const uint8_t*)&record, offsetof(UplinkSlot_t, crc));
+    EEPROM.put(getSlotAddr(slot), record);
+    this->eepromCount++;
+    this->ramHead = (this->ramHead + 1) % UPLINK_QUEUE_RAM_SLOTS;
+    this->ramCount--;
+}
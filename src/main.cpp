@@ -25,6 +25,9 @@ void setup() {
   // Delay time (5 sec.) for systems stabilization
   delay(5000);
 
+  // Load sampling and transmission periods (may be changed by downlink)
+  loadPeriods();
+
   // Initiate and check air temperature and humidity (DHT-22) sensor
   #ifdef SENSOR_DHT_ENABLED
     setupStatus = initSensorDHT();
@@ -145,12 +148,12 @@ void setup() {
   #endif // SENSOR_ANEMOMETER_ENABLED   
 
   // Populate LoRa cofiguration struct
-  loraCfg.serialLora = &SERIAL_LORA;
-  loraCfg.baseband = AU920;
+  loraCfg.uart_baudrate = LORA_BAUDRATE;
+  loraCfg.baseband = lora_baseband;
   loraCfg.subband = 2;
   loraCfg.op_class = A;
   loraCfg.tx_power = dBm20;
-  loraCfg.uplink_dr = DR1;
+  loraCfg.uplink_dr = lora_uplink_dr;
   // loraCfg.chan0_freq = chan0_freq;
   loraCfg.chan0_dr = DR1;
   // loraCfg.chan1_freq = chan1_freq;
@@ -162,14 +165,22 @@ void setup() {
   loraCfg.dev_eui = dev_eui;
   loraCfg.app_eui = app_eui;
   // loraCfg.repeat = repeat;
-  // loraCfg.retry = retry;
+  loraCfg.retry = retry;
+  loraCfg.retry_backoff = retry_backoff;
+  loraCfg.confirm_every = confirm_every;
+  loraCfg.downlink_budget = downlink_budget;
+  loraCfg.link_check_every = link_check_every;
+  loraCfg.time_sync_period = time_sync_period;
+  loraCfg.airtime_budget = airtime_budget;
+  loraCfg.airtime_window = airtime_window;
+  loraCfg.low_power = lora_low_power;
   loraCfg.dev_addr = dev_addr;
-  // loraCfg.app_key = app_key;
+  loraCfg.app_key = app_key;
   loraCfg.apps_key = apps_key;
   loraCfg.nwks_key = nwks_key;
+  loraCfg.eeprom_addr = EEPROM_LORA_ADDR;
   #ifdef SERIAL_DEBUG_ENABLED
-    loraCfg.serialDebug = &SERIAL_DEBUG;
-    loraCfg.debug = true;
+    LoRaSerialLog::begin(SERIAL_DEBUG);
   #endif
 
   // Initiate LoRa modem
@@ -178,13 +189,6 @@ void setup() {
     SERIAL_DEBUG.flush();
   #endif
   if (lora.init(loraCfg) != LORA_STATUS_OK) {
-    #ifdef SERIAL_DEBUG_ENABLED
-      if (!loraCfg.debug) {
-        SERIAL_DEBUG.print(F("[FAIL]"));      
-        SERIAL_DEBUG.flush();
-      }      
-    #endif
-
     // Put RGB LED in error mode
     #ifdef RGB_LED_ENABLED        
       rgb_led.on(Color(255,0,0));
@@ -193,14 +197,9 @@ void setup() {
     // Put station in ERROR mode
     delay(error_reset_period);
     setup();
-  } else {
-    #ifdef SERIAL_DEBUG_ENABLED
-      if (!loraCfg.debug) {
-        SERIAL_DEBUG.print(F("[OK]"));
-        SERIAL_DEBUG.flush();
-      }
-    #endif
   }
+  lora.setTxCallback(loraTxCallback);
+  lora.setRxHandler(remote_cmd_port, remoteCmdHandler);
 
   // If setup status OK, turn off RGB LED
   if (POWER_SUPPLY == POWER_LINE) {
@@ -217,6 +216,9 @@ void setup() {
 }
 
 void loop() {  
+  // Process LoRa modem responses (never blocks)
+  lora.poll();
+
   // If device is power line based it will run continually
   if (POWER_SUPPLY == POWER_LINE) {
     
@@ -258,6 +260,10 @@ void loop() {
         lastSamplingPeriod = now;
         turnAroundSamplingOK = false;
 
+        // Keep sensor data, so the new sample can be added to the history batch
+        station_sensor_t before = sensorsData;
+        sensorsData.sampleTime = now;
+
         // Power on RGB LED in sampling mode
         #ifdef RGB_LED_ENABLED          
           rgb_led.on(Color(0,255,0));
@@ -397,6 +403,11 @@ void loop() {
           }            
         #endif
 
+        // Add sample to the history batch
+        if (history_port != 0) {
+          addHistorySample(before);
+        }
+
         // Terminating sampling process
         #ifdef SERIAL_DEBUG_ENABLED
           SERIAL_DEBUG.print(F("\n===========================================================\n"));    
@@ -419,71 +430,79 @@ void loop() {
         }
       }
 
-      // Check transmission period
+      // Check transmission period, channels due in this window are marked pending
       if (((now - lastTxPeriod) >= txPeriod) || turnAroundTxOK) {
         
         // Update lastTxPeriod and turnAroundTxOK
         lastTxPeriod = now;
         turnAroundTxOK = false;
+        txWindow++;
 
-        // Power on RGB LED in transmission mode
-        #ifdef RGB_LED_ENABLED          
-          rgb_led.on(Color(0,0,255));
-        #endif
-
-        delay(500);
+        for (uint8_t i = 0; i < uplink_channels_count; i++) {
+          if ((txWindow % uplink_channels[i].every) == 0) {
+            channelsPending |= (1 << i);
+          }
+        }
 
         // Check if serial debug is enabled
         #ifdef SERIAL_DEBUG_ENABLED
           printAverageValues();                       
         #endif
+      } // if (((now - lastTxPeriod) >= txPeriod) || turnAroundTxOK)
 
-        // Create message payload (25 bytes)
-        // ATS-02 payload layout:
-        // 2 bytes - air temperature (float2int15)
-        // 2 bytes - air umidity (float2uint16)        
-        // 2 bytes - soil temperature (float2int15)
-        // 2 bytes - soil moisture (float2uint16)
-        // 2 bytes - leaf moisture (float2uint16)
-        // 1 byte  - UV index (uint8)
-        // 2 bytes - light (float2uint16)        
-        // 2 bytes - wind direction voltage (float2uint16)
-        // 2 bytes - wind speed (float2uint16)
-        // 2 bytes - pluviometer turn around (uint16)
-        // 2 bytes - pressure (float2uint16)
-        // 2 byte  - device temperature (float2int15)
-        // 2 bytes - power supply (float2uint16)
-        payload = "";        
-        payload.concat(short2hex(float2int15((sensorsData.airTemp/sensorsData.airTempCount), 2)));
-        payload.concat(short2hex(float2uint16((sensorsData.airHumid/sensorsData.airHumidCount), 2)));
-        payload.concat(short2hex(float2int15((sensorsData.soilTemp/sensorsData.soilTempCount), 2)));
-        payload.concat(short2hex(float2uint16((sensorsData.soilMoisture/sensorsData.soilMoistureCount), 2)));
-        payload.concat(short2hex(float2uint16((sensorsData.leafMoisture/sensorsData.leafMoistureCount), 2)));
-        payload.concat(byte2hex(convertMilliVoltsToIndex(sensorsData.uvVoltage/sensorsData.uvVoltageCount)));              
-        payload.concat(short2hex(float2uint16((sensorsData.light/sensorsData.lightCount), 0)));
-        //payload.concat(short2hex(convertVoltsToWindDirection(sensorsData.windDirVoltage/sensorsData.windDirCount)));
-        payload.concat(short2hex(float2uint16((sensorsData.windDirVoltage/sensorsData.windDirCount), 2)));
-        payload.concat(short2hex(float2uint16((sensorsData.windSpeed/sensorsData.windSpeedCount), 2)));
-        noInterrupts();
-        uint16_t turn_around = sensorsData.pluviometerTurnAround;
-        sensorsData.pluviometerTurnAround = 0;
-        interrupts(); 
-        payload.concat(short2hex(turn_around));
-        payload.concat(short2hex(float2uint16((sensorsData.pressure/sensorsData.pressureCount), 0)));
-        payload.concat(short2hex(float2int15((sensorsData.devTemp/sensorsData.devTempCount), 2)));
-        payload.concat(short2hex(float2uint16((sensorsData.powerSupply/sensorsData.powerSupplyCount), 2)));                
-
-        // Send data values        
-        lora.sendNoAckMsgHex(1, payload);
-
-        // Reset sensor data struct
-        resetSensorDataStruct();
+      // Send pending channels one at a time, never back to back. Transmission is deferred 
+      // while the modem is busy or the airtime budget is exhausted, so the samples are 
+      // coalesced in the next frame
+      if ((channelsPending != 0) && ((now - lastUplinkTx) >= uplink_gap) && !lora.isBusy()) {
+        uint8_t channel = 0;
+        while ((channelsPending & (1 << channel)) == 0) {
+          channel++;
+        }
 
-        // Power off RGB LED
-        #ifdef RGB_LED_ENABLED                  
-          rgb_led.off();
-        #endif
-      } // if (((now - lastTxPeriod) >= txPeriod) || turnAroundTxOK)
+        if (!isReportDue(channel)) {
+          // Nothing changed beyond the deadbands, so the window is dropped
+          channelsPending &= ~(1 << channel);
+          skipChannel(channel);
+        } else if (lora.getAirtimeWait(getChannelSize(channel)) == 0) {
+          lastUplinkTx = now;
+          channelsPending &= ~(1 << channel);
+
+          // Power on RGB LED in transmission mode
+          #ifdef RGB_LED_ENABLED          
+            rgb_led.on(Color(0,0,255));
+          #endif
+
+          // Send channel frame (or queue it while the link is down)
+          sendChannel(channel);
+
+          // Power off RGB LED
+          #ifdef RGB_LED_ENABLED                  
+            rgb_led.off();
+          #endif
+        }
+      }
+
+      // Synchronize clock when no channel frame is due
+      if ((channelsPending == 0) && lora.isTimeSyncDue() && ((now - lastUplinkTx) >= uplink_gap) && 
+          lora.isJoined() && !lora.isBusy() && (lora.getAirtimeWait(LORA_TIME_SYNC_MAX_SIZE) == 0)) {
+        lastUplinkTx = now;
+        sendTimeSync();
+      }
+
+      // Send history fragments when no channel frame is due
+      if ((channelsPending == 0) && fragmenter.pending() && ((now - lastUplinkTx) >= uplink_gap) && 
+          lora.isJoined() && !lora.isBusy() && (lora.getAirtimeWait(lora.getMaxPayloadSize()) == 0)) {
+        lastUplinkTx = now;
+        sendFragment();
+      }
+
+      // Drain queued frames at a controlled rate
+      if ((uplinkQueue.count() != 0) && ((now - lastBackfillPeriod) >= backfill_period) && 
+          ((now - lastUplinkTx) >= uplink_gap) && lora.isJoined() && !lora.isBusy()) {
+        lastBackfillPeriod = now;
+        lastUplinkTx = now;
+        sendBackfill();
+      }
 
     } // if (((now - lastSystemPeriod) >= systemPeriod) || turnAroundSystemOK) {
 
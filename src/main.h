@@ -18,8 +18,19 @@
 #define __MAIN_H__
 
 #include <Arduino.h>
+#include <EEPROM.h>
 #include "ats_02_setup.h"
-#include "LoRa.h"
+#if defined(LORA_RADIO_RN2483)
+    #include "RN2483.h"
+#elif defined(LORA_RADIO_SX127X)
+    #include "SX127x.h"
+#else
+    #include "RHF76.h"
+#endif
+#include "UplinkQueue.h"
+#include "Fragment.h"
+#include "FieldStats.h"
+#include "convert_tools.h"
 #ifdef RGB_LED_ENABLED
     #include "RGBLed.h"
 #endif
@@ -56,6 +67,7 @@ struct up_time_t {
 };
 
 struct station_sensor_t {
+    uint32_t sampleTime = 0;    /**< Time (millis()) of the last sampling. */
     #ifdef SENSOR_DHT_ENABLED
         float airTemp = 0.0f;
         uint8_t airTempCount = 0;
@@ -91,6 +103,8 @@ struct station_sensor_t {
     #ifdef SENSOR_PLUVIOMETER_ENABLED
         float rainVolume = 0.0f;        
         uint16_t pluviometerTurnAround = 0;        
+        uint16_t pluviometerReported = 0;   /**< Turn arounds written in the last payload. */
+        uint16_t pluviometerTotal = 0;      /**< Turn arounds since power on (never cleared, wraps). */
     #endif
     #ifdef SENSOR_POWER_SUPPLY_ENABLED
         float powerSupply = 0.0f;
@@ -108,6 +122,91 @@ struct station_sensor_t {
     #endif
 };
 
+/**
+ * @struct channel_state_t
+ * @brief Delta encoding and report by exception state of an uplink channel.
+ */
+struct channel_state_t {
+    payload_frame_t keyframe;           /**< Last acknowledged keyframe. */
+    bool keyframeValid = false;         /**< A keyframe was acknowledged. */
+    uint8_t keyframeIndex = 0;          /**< Index of the acknowledged keyframe. */
+    uint8_t deltaCount = 0;             /**< Delta frames sent since the keyframe. */
+    uint8_t skipped = 0;                /**< Frames skipped (no change) since the last frame sent. */
+};
+
+/**
+ * @struct periods_record_t
+ * @brief Sampling and transmission periods stored in EEPROM.
+ */
+struct periods_record_t {
+    uint16_t magic;             /**< Record marker (see \ref PERIODS_EEPROM_MAGIC). */
+    uint32_t samplingPeriod;    /**< Sampling period (in ms). */
+    uint32_t txPeriod;          /**< Transmission period (in ms). */
+};
+
+/**
+ * \def PERIODS_EEPROM_MAGIC
+ * Marker of a valid periods record in EEPROM.
+ */
+#define PERIODS_EEPROM_MAGIC    0x5045
+
+/**
+ * @enum remote_cmd_e
+ * @brief Remote commands received by downlink on \ref remote_cmd_port.
+ * @details Each command is an opcode followed by its argument (uint16, low byte first). 
+ *          Several commands may be sent in the same downlink.
+ * @var REMOTE_CMD_SAMPLING_PERIOD
+ * Set sampling period (argument in seconds).
+ * @var REMOTE_CMD_TX_PERIOD
+ * Set transmission period (argument in seconds).
+ */
+enum remote_cmd_e {
+    REMOTE_CMD_SAMPLING_PERIOD = 0x01,
+    REMOTE_CMD_TX_PERIOD = 0x02
+};
+
+/**
+ * @enum uplink_kind_e
+ * @brief Kind of the uplink in transmission (tells \ref loraTxCallback() what to do 
+ *        when it ends).
+ * @var UPLINK_CHANNEL
+ * Channel frame (queued if it fails).
+ * @var UPLINK_BACKFILL
+ * Queued frame (removed from the queue once delivered).
+ * @var UPLINK_FRAGMENT
+ * History fragment (sent again if it fails).
+ * @var UPLINK_TIME_SYNC
+ * Clock synchronization request.
+ */
+enum uplink_kind_e {
+    UPLINK_CHANNEL,
+    UPLINK_BACKFILL,
+    UPLINK_FRAGMENT,
+    UPLINK_TIME_SYNC
+};
+
+/**
+ * @typedef LoRaLog
+ * @brief LoRa driver logging, debug messages are only compiled in serial debug builds.
+ */
+#ifdef SERIAL_DEBUG_ENABLED
+    typedef LoRaSerialLog LoRaLog;
+#else
+    typedef LoRaNoLog LoRaLog;
+#endif
+
+/**
+ * @typedef LoRa
+ * @brief LoRaWAN radio backend selected in ats_02_setup.h (AT modems use \ref SERIAL_LORA).
+ */
+#if defined(LORA_RADIO_RN2483)
+    typedef RN2483<HardwareSerial, LoRaLog> LoRa;
+#elif defined(LORA_RADIO_SX127X)
+    typedef SX127x<LoRaLog> LoRa;
+#else
+    typedef RHF76<HardwareSerial, LoRaLog> LoRa;
+#endif
+
 /*******************************************************
  *                FUNCTIONS PROTOTYPES
  *******************************************************/
@@ -172,6 +271,101 @@ struct station_sensor_t {
     uint8_t getPressureSensorValue();
     uint8_t getDeviceTempSensorValue();
 #endif
+void loraTxCallback(LoRaTxStatus_e txStatus, uint8_t statusCode);
+uint16_t getTimestamp(uint32_t ms);
+uint16_t getPresentFields(uint16_t fields, const station_sensor_t& data);
+void buildChannelFrame(uint16_t fields, const station_sensor_t& data, payload_frame_t& frame);
+template <uint16_t Field, class T> void addFieldStats(T value);
+bool buildChannelStats(const uplink_channel_t& config, payload_stats_t& stats);
+void resetSensorData(uint16_t fields);
+void diffSensorData(uint16_t fields, station_sensor_t& data, const station_sensor_t& before);
+void sendChannel(uint8_t channel);
+bool isReportDue(uint8_t channel);
+bool exceedsDeadband(uint8_t index, uint16_t raw);
+void skipChannel(uint8_t channel);
+void sendTimeSync();
+void addHistorySample(const station_sensor_t& before);
+void sendFragment();
+void dropFragments();
+bool sendUplink(bool confirmed);
+void sendBackfill();
+void remoteCmdHandler(uint8_t port, const uint8_t* buf, uint8_t size);
+void loadPeriods();
+void savePeriods();
+/**
+ * @fn getChannelSize
+ * @brief Get the maximum frame size (in bytes) of a channel, header and window 
+ *        statistics included.
+ * @param[in] channel - index in \ref uplink_channels.
+ */
+constexpr uint8_t getChannelSize(uint8_t channel) {
+    return PAYLOAD_HEADER_SIZE + getPayloadSize(uplink_channels[channel].fields, 
+                                                getStatsBits(uplink_channels[channel].stats[STAT_MIN]) + 
+                                                getStatsBits(uplink_channels[channel].stats[STAT_MAX]) + 
+                                                getStatsBits(uplink_channels[channel].stats[STAT_STDDEV]));
+}
+
+/**
+ * @fn channelsFit
+ * @brief Check (at compile time) that every channel frame fits in a LoRa payload at 
+ *        \ref lora_uplink_dr.
+ * @details If ADR lowers the datarate below it, frames that no longer fit are dropped 
+ *          (see \ref sendUplink()).
+ */
+constexpr bool channelsFit(uint8_t channel = 0) {
+    return (channel >= uplink_channels_count) || 
+           ((getChannelSize(channel) <= getLoRaMaxPayloadSize(lora_baseband, lora_uplink_dr)) && channelsFit(channel + 1));
+}
+static_assert(channelsFit(), "Uplink channel frame larger than the LoRa payload at lora_uplink_dr");
+
+/**
+ * @fn getStatsFields
+ * @brief Get the fields with window statistics in any channel (bit mask).
+ */
+constexpr uint16_t getStatsFields(uint8_t channel = 0) {
+    return (channel >= uplink_channels_count) ? 0 :
+           (uplink_channels[channel].stats[STAT_MIN] | uplink_channels[channel].stats[STAT_MAX] | 
+            uplink_channels[channel].stats[STAT_STDDEV] | getStatsFields(channel + 1));
+}
+
+/**
+ * @fn statsInChannels
+ * @brief Check (at compile time) that window statistics are set only for averaged 
+ *        fields of their own channel.
+ */
+constexpr bool statsInChannels(uint8_t channel = 0) {
+    return (channel >= uplink_channels_count) ||
+           ((((uplink_channels[channel].stats[STAT_MIN] | uplink_channels[channel].stats[STAT_MAX] | 
+               uplink_channels[channel].stats[STAT_STDDEV]) & ~uplink_channels[channel].fields) == 0) && 
+            statsInChannels(channel + 1));
+}
+static_assert(statsInChannels(), "Uplink channel statistics set for a field out of the channel");
+static_assert((getStatsFields() & (FIELD_WIND_DIR | FIELD_RAIN | FIELD_LINK_HEALTH | FIELD_TIMESTAMP)) == 0, 
+              "Window statistics are only kept for averaged fields");
+
+/**
+ * @fn countFields
+ * @brief Get the number of fields in a bit mask.
+ */
+constexpr uint8_t countFields(uint16_t fields) {
+    return (fields == 0) ? 0 : (fields & 0x0001) + countFields(fields >> 1);
+}
+
+const uint16_t stats_fields = getStatsFields();         /**< Fields with window statistics (bit mask). */
+const uint8_t stats_count = countFields(stats_fields);  /**< Number of fields with window statistics. */
+
+/**
+ * @fn getStatsIndex
+ * @brief Get the index of a field in \ref fieldStats.
+ */
+constexpr uint8_t getStatsIndex(uint16_t field) {
+    return countFields(stats_fields & (field - 1));
+}
+// History samples are fragmented at the current datarate, they only have to fit the 
+// sample buffer (see addHistorySample()) and a batch (after its 7 byte header)
+static_assert(getPayloadSize(history_fields) <= LORA_MAX_PAYLOAD_SIZE, "History sample larger than LORA_MAX_PAYLOAD_SIZE");
+static_assert((7 + getPayloadSize(history_fields)) <= history_block_size, "History sample larger than history_block_size");
+
 /*******************************************************
  *                  GLOBAL VARIABLES
  *******************************************************/
@@ -181,12 +375,48 @@ bool turnAroundSystemOK = false;
 uint32_t lastSamplingPeriod = 0;
 bool turnAroundSamplingOK = false;
 uint32_t lastTxPeriod = 0;
+uint32_t samplingPeriod = defaultSamplingPeriod;    /**< Sampling period (in ms). */
+uint32_t txPeriod = defaultTxPeriod;                /**< Transmission period (in ms). */
 bool turnAroundTxOK = false;
 station_sensor_t sensorsData;
 LoRaConfig_t loraCfg;                   /**< LoRa configuration struct. */
-LoRa lora;                              /**< Global variable to access LoRa modem. */
-String payload = "";
-uint16_t payload_aux = 0;
+#ifdef LORA_RADIO_SX127X
+    LoRa lora;                          /**< Global variable to access LoRa radio. */
+    const lmic_pinmap lmic_pins = {     /**< SX127x pins used by LMIC. */
+        .nss = LORA_NSS_PIN,
+        .rxtx = LMIC_UNUSED_PIN,
+        .rst = LORA_RST_PIN,
+        .dio = {LORA_DIO0_PIN, LORA_DIO1_PIN, LMIC_UNUSED_PIN},
+    };
+#else
+    LoRa lora(SERIAL_LORA);             /**< Global variable to access LoRa modem. */
+#endif
+uint8_t payload[LORA_MAX_PAYLOAD_SIZE];  /**< Uplink payload buffer. */
+uint8_t payloadSize = 0;                /**< Uplink payload size (in bytes). */
+uint8_t payloadPort = 0;                /**< Uplink payload LoRa port. */
+uint16_t txWindow = 0;                  /**< Transmission window index. */
+uint8_t channelsPending = 0;            /**< Uplink channels due to be sent (bit mask). */
+uint8_t channelsStarted = 0;            /**< Uplink channels with a frame built since power on (bit mask). */
+channel_state_t channelState[uplink_channels_count];    /**< Delta encoding and report by exception state of each uplink channel. */
+uint16_t reportedFields = 0;            /**< Fields present in the last frames sent (bit mask). */
+uint16_t reportedRaw[FIELD_COUNT];      /**< Raw values of the last frames sent, indexed by field bit position. */
+payload_frame_t keyframePending;        /**< Last frame built, kept as keyframe once acknowledged. */
+int8_t keyframeChannel = -1;            /**< Channel of the keyframe in transmission (-1 = none). */
+FieldStats fieldStats[stats_count ? stats_count : 1];  /**< Window statistics of \ref stats_fields. */
+uint32_t lastUplinkTx = 0;              /**< Time of the last uplink (channel frame or backfill). */
+UplinkQueue uplinkQueue(EEPROM_QUEUE_ADDR, queue_eeprom_slots, queue_max_age);  /**< Frames waiting to be sent. */
+uplink_kind_e uplinkKind = UPLINK_CHANNEL;  /**< Kind of the uplink in transmission. */
+uint16_t backfillWindow = 0;            /**< Window index of the queued frame in transmission. */
+uint32_t lastBackfillPeriod = 0;
+uint8_t historyBlock[history_block_size];   /**< History batch being sampled. */
+uint8_t historySize = 0;                /**< History batch size (in bytes). */
+uint8_t historyCount = 0;               /**< Samples in the history batch. */
+uint32_t historyStart = 0;              /**< Time (millis()) of the first sample of the history batch. */
+uint16_t historyRainMark = 0;           /**< Pluviometer total at the last history sample. */
+uint8_t historyOut[history_block_size]; /**< History batch being sent (see \ref fragmenter). */
+Fragmenter fragmenter;                  /**< Splits history batches in fragments. */
+uint8_t fragmentFailures = 0;           /**< Consecutive failures of the current fragment. */
+uint8_t fragmentBatch = 0;              /**< Batch of the fragment in transmission (see \ref Fragmenter::getBatch()). */
 #ifdef RGB_LED_ENABLED
     RGBLed rgb_led(LED_RGB_TYPE, LED_RGB_RED_PIN, LED_RGB_GREEN_PIN, LED_RGB_BLUE_PIN);  /**< Global variable to access RGB LED device. */
 #endif
@@ -352,6 +582,7 @@ uint8_t getDHTTemperature() {
     else {
         sensorsData.airTemp += event.temperature;
         sensorsData.airTempCount++;
+        addFieldStats<FIELD_AIR_TEMP>(event.temperature);
         #ifdef SERIAL_DEBUG_ENABLED
             SERIAL_DEBUG.print(F("\nAir temperature (in oC): "));
             SERIAL_DEBUG.print(event.temperature);           
@@ -374,6 +605,7 @@ uint8_t getDHTHumidity() {
     else {
         sensorsData.airHumid += event.relative_humidity;
         sensorsData.airHumidCount++;
+        addFieldStats<FIELD_AIR_HUMID>(event.relative_humidity);
         #ifdef SERIAL_DEBUG_ENABLED
             SERIAL_DEBUG.print(F("\nAir humidity (in %): "));
             SERIAL_DEBUG.print(event.relative_humidity);            
@@ -430,6 +662,7 @@ uint8_t getLightSensorValue() {
     } else {
         sensorsData.light += (uint32_t)lux;
         sensorsData.lightCount++;
+        addFieldStats<FIELD_LIGHT>(lux);
         #ifdef SERIAL_DEBUG_ENABLED
             SERIAL_DEBUG.print(F("\nLight (in Lux): ")); SERIAL_DEBUG.print(lux);
             SERIAL_DEBUG.flush();
@@ -471,6 +704,7 @@ uint8_t getUVSensorValue() {
     } else {
         sensorsData.uvVoltage += (uint32_t)sensorVoltage;
         sensorsData.uvVoltageCount++;
+        addFieldStats<FIELD_UV>(convertMilliVoltsToIndex(sensorVoltage));
         #ifdef SERIAL_DEBUG_ENABLED
             SERIAL_DEBUG.print(F("\nUV voltage (in milliVolts): ")); SERIAL_DEBUG.print(sensorVoltage);
             SERIAL_DEBUG.print(F(" => Index: ")); SERIAL_DEBUG.print(convertMilliVoltsToIndex(sensorVoltage));
@@ -565,6 +799,7 @@ uint8_t getSoilTempSensorValue() {
     } else {
         sensorsData.soilTemp += soil_temp;
         sensorsData.soilTempCount++;
+        addFieldStats<FIELD_SOIL_TEMP>(soil_temp);
         #ifdef SERIAL_DEBUG_ENABLED
             SERIAL_DEBUG.print(F("\nSoil temperature (in oC): ")); SERIAL_DEBUG.print(soil_temp);
             SERIAL_DEBUG.flush();
@@ -607,6 +842,7 @@ uint8_t getSoilMoistureSensorValue() {
         // Map analog value using 10 bits resolution ADC
         sensorsData.soilMoisture += map(soil_analog, 0, 1023, 100, 0);
         sensorsData.soilMoistureCount++;
+        addFieldStats<FIELD_SOIL_MOISTURE>(map(soil_analog, 0, 1023, 100, 0));
         #ifdef SERIAL_DEBUG_ENABLED
             SERIAL_DEBUG.print(F("\nSoil moisture (in %): ")); SERIAL_DEBUG.print(map(soil_analog, 0, 1023, 100, 0));
             SERIAL_DEBUG.flush();
@@ -645,6 +881,7 @@ uint8_t getLeafMoistureSensorValue() {
         // Map analog value using 10 bits resolution ADC
         sensorsData.leafMoisture += map(leaf_analog, 0, 1023, 100, 0);
         sensorsData.leafMoistureCount++;
+        addFieldStats<FIELD_LEAF_MOISTURE>(map(leaf_analog, 0, 1023, 100, 0));
         #ifdef SERIAL_DEBUG_ENABLED
             SERIAL_DEBUG.print(F("\nLeaf moisture (in %): ")); SERIAL_DEBUG.print(map(leaf_analog, 0, 1023, 100, 0));
             SERIAL_DEBUG.flush();
@@ -748,6 +985,7 @@ uint8_t getPowerSupplySensorValue() {
     } else {
         sensorsData.powerSupply += bus_voltage;
         sensorsData.powerSupplyCount++;
+        addFieldStats<FIELD_POWER_SUPPLY>(bus_voltage);
         #ifdef SERIAL_DEBUG_ENABLED
             SERIAL_DEBUG.print(F("\nPower supply (in Volts): ")); SERIAL_DEBUG.print(bus_voltage);
             SERIAL_DEBUG.flush();
@@ -792,6 +1030,7 @@ uint8_t getPressureSensorValue() {
     } else {
         sensorsData.pressure += pressure;
         sensorsData.pressureCount++;
+        addFieldStats<FIELD_PRESSURE>(pressure);
         #ifdef SERIAL_DEBUG_ENABLED
             SERIAL_DEBUG.print(F("\nPressure (in hPa): ")); SERIAL_DEBUG.print(pressure);
             SERIAL_DEBUG.flush();
@@ -811,6 +1050,7 @@ uint8_t getDeviceTempSensorValue() {
     } else {
         sensorsData.devTemp += devTemp;
         sensorsData.devTempCount++;
+        addFieldStats<FIELD_DEV_TEMP>(devTemp);
         #ifdef SERIAL_DEBUG_ENABLED
             SERIAL_DEBUG.print(F("\nDevice temperature (in oC): ")); SERIAL_DEBUG.print(devTemp);
             SERIAL_DEBUG.flush();
@@ -880,6 +1120,7 @@ uint8_t getWindSpeedSensorValue() {
         // Storage wind speed
         sensorsData.windSpeed += wind_speed;
         sensorsData.windSpeedCount++;
+        addFieldStats<FIELD_WIND_SPEED>(wind_speed);
         #ifdef SERIAL_DEBUG_ENABLED
             SERIAL_DEBUG.print(F("\nWind speed (in Km/h): ")); SERIAL_DEBUG.print(wind_speed);
             SERIAL_DEBUG.print(F(" - RPM: ")); SERIAL_DEBUG.print(RPM);
@@ -908,6 +1149,7 @@ uint8_t initSensorPluviometer() {
 
 void pluviometerTurnAroundIncrement() {
     sensorsData.pluviometerTurnAround++;
+    sensorsData.pluviometerTotal++;
 }
 
 uint8_t getRainVolumeSensorValue() {    
@@ -939,53 +1181,882 @@ uint8_t getRainVolumeSensorValue() {
 
 #endif // SENSOR_PLUVIOMETER_ENABLED
 
-void resetSensorDataStruct() {
+#ifdef LORA_RADIO_SX127X
+/**
+ * @fn os_getArtEui
+ * @brief Give LMIC the OTAA AppEUI (LSB first).
+ */
+void os_getArtEui(u1_t* buf) {
+    lora.getAppEUI(buf);
+}
+
+/**
+ * @fn os_getDevEui
+ * @brief Give LMIC the OTAA DevEUI (LSB first).
+ */
+void os_getDevEui(u1_t* buf) {
+    lora.getDevEUI(buf);
+}
+
+/**
+ * @fn os_getDevKey
+ * @brief Give LMIC the OTAA AppKey (MSB first).
+ */
+void os_getDevKey(u1_t* buf) {
+    lora.getAppKey(buf);
+}
+#endif // LORA_RADIO_SX127X
+
+/**
+ * @fn loraTxCallback
+ * @brief Called by LoRa driver when a transmission ends.
+ * @param[in] txStatus - transmission status.
+ * @param[in] statusCode - LoRa status code (see \ref LoRaStatusCode_e).
+ */
+void loraTxCallback(LoRaTxStatus_e txStatus, uint8_t statusCode) {
+    UplinkFrame_t frame;
+
+    if (uplinkKind == UPLINK_FRAGMENT) {
+        // Failed fragment is sent again, up to history_max_failures times. A fragment of
+        // a batch replaced during its transmission does not move the new batch on
+        if (fragmentBatch != fragmenter.getBatch()) {
+            fragmentFailures = 0;
+        } else if (txStatus == LORA_TX_DONE) {
+            fragmenter.next();
+            fragmentFailures = 0;
+        } else if (++fragmentFailures >= history_max_failures) {
+            dropFragments();
+        }
+    } else if (uplinkKind == UPLINK_BACKFILL) {
+        // Remove queued frame once delivered or rejected by the radio (unless it was 
+        // dropped meanwhile)
+        if (((txStatus == LORA_TX_DONE) || (statusCode == LORA_STATUS_INVALID_PARAM)) && 
+            uplinkQueue.peek(frame) && (frame.window == backfillWindow)) {
+            uplinkQueue.pop();
+        }
+    } else if ((uplinkKind == UPLINK_CHANNEL) && (txStatus == LORA_TX_FAILED)) {
+        // Keep the window to be sent later, unless the radio rejected the frame itself
+        if (statusCode != LORA_STATUS_INVALID_PARAM) {
+            uplinkQueue.push(payloadPort, txWindow, payload, payloadSize);
+        }
+    } else if ((uplinkKind == UPLINK_CHANNEL) && (keyframeChannel >= 0)) {
+        // Acknowledged keyframe is the reference of the next delta frames
+        channel_state_t& state = channelState[keyframeChannel];
+        state.keyframe = keyframePending;
+        state.keyframeValid = true;
+        state.keyframeIndex++;
+        state.deltaCount = 0;
+    }
+    uplinkKind = UPLINK_CHANNEL;
+    keyframeChannel = -1;
+
+    if (txStatus == LORA_TX_FAILED) {
+        #ifdef SERIAL_DEBUG_ENABLED
+            SERIAL_DEBUG.print(F("\nLoRa transmission failed with status code "));
+            SERIAL_DEBUG.print(statusCode);
+            SERIAL_DEBUG.print(F(", queued frames: "));
+            SERIAL_DEBUG.print(uplinkQueue.count());
+            SERIAL_DEBUG.flush();
+        #endif
+        // Power on RGB LED in error mode
+        #ifdef RGB_LED_ENABLED
+            rgb_led.on(Color(255,0,0));
+        #endif
+    }
+}
+
+/**
+ * @fn getTimestamp
+ * @brief Get the compact timestamp of a local time: GPS time in minutes, modulo 65535 
+ *        (about 45 days, backend takes the occurrence closest to the frame reception).
+ * @details Frames are stamped when built, so queued and late frames are still placed
+ *          at the right time.
+ * @param[in] ms - local time (millis()).
+ * @return uint16_t - timestamp, 0xFFFF if the clock is not synchronized yet.
+ */
+uint16_t getTimestamp(uint32_t ms) {
+    if (!lora.isTimeSynced()) {
+        return 0xFFFF;
+    }
+
+    return (lora.getGpsTime(ms) / 60) % 0xFFFF;
+}
+
+/**
+ * @fn getPresentFields
+ * @brief Get the selected fields that have samples (sensor enabled and at least one 
+ *        valid reading), so no average is computed over zero samples.
+ * @param[in] fields - fields bit mask.
+ * @param[in] data - sensor samples.
+ * @return uint16_t - present fields bit mask.
+ */
+uint16_t getPresentFields(uint16_t fields, const station_sensor_t& data) {
+    uint16_t present = FIELD_LINK_HEALTH;
+
+    #ifdef SENSOR_DHT_ENABLED
+        if (data.airTempCount != 0) {
+            present |= FIELD_AIR_TEMP;
+        }
+        if (data.airHumidCount != 0) {
+            present |= FIELD_AIR_HUMID;
+        }
+    #endif
+    #ifdef SENSOR_SOIL_TEMP_ENABLED
+        if (data.soilTempCount != 0) {
+            present |= FIELD_SOIL_TEMP;
+        }
+    #endif
+    #ifdef SENSOR_SOIL_MOISTURE_ENABLED
+        if (data.soilMoistureCount != 0) {
+            present |= FIELD_SOIL_MOISTURE;
+        }
+    #endif
+    #ifdef SENSOR_LEAF_MOISTURE_ENABLED
+        if (data.leafMoistureCount != 0) {
+            present |= FIELD_LEAF_MOISTURE;
+        }
+    #endif
+    #ifdef SENSOR_UV_ENABLED
+        if (data.uvVoltageCount != 0) {
+            present |= FIELD_UV;
+        }
+    #endif
+    #ifdef SENSOR_LIGHT_ENABLED
+        if (data.lightCount != 0) {
+            present |= FIELD_LIGHT;
+        }
+    #endif
+    #ifdef SENSOR_WIND_SOCK_ENABLED
+        if (data.windDirCount != 0) {
+            present |= FIELD_WIND_DIR;
+        }
+    #endif
+    #ifdef SENSOR_ANEMOMETER_ENABLED
+        if (data.windSpeedCount != 0) {
+            present |= FIELD_WIND_SPEED;
+        }
+    #endif
+    #ifdef SENSOR_PLUVIOMETER_ENABLED
+        present |= FIELD_RAIN;
+    #endif
+    #ifdef SENSOR_PRESSURE_ENABLED
+        if (data.pressureCount != 0) {
+            present |= FIELD_PRESSURE;
+        }
+        if (data.devTempCount != 0) {
+            present |= FIELD_DEV_TEMP;
+        }
+    #endif
+    #ifdef SENSOR_POWER_SUPPLY_ENABLED
+        if (data.powerSupplyCount != 0) {
+            present |= FIELD_POWER_SUPPLY;
+        }
+    #endif
+    if (lora.isTimeSynced()) {
+        present |= FIELD_TIMESTAMP;
+    }
+
+    return present & fields;
+}
+
+/**
+ * @fn buildChannelFrame
+ * @brief Get the raw values (see \ref field_schema) of the averages of the selected 
+ *        fields that have samples.
+ * @details Samples are kept until \ref resetSensorData(), so the frame may be built 
+ *          again. Rain is taken from \ref station_sensor_t::pluviometerReported.
+ * @param[in] fields - fields bit mask.
+ * @param[in] data - sensor samples.
+ * @param[out] frame - raw values.
+ */
+void buildChannelFrame(uint16_t fields, const station_sensor_t& data, payload_frame_t& frame) {
+    uint16_t present = getPresentFields(fields, data);
+    frame.present = present;
+
+    #ifdef SENSOR_DHT_ENABLED
+        if (present & FIELD_AIR_TEMP) {
+            frame.raw[getFieldIndex(FIELD_AIR_TEMP)] = encodeField<FIELD_AIR_TEMP>(data.airTemp/data.airTempCount);
+        }
+        if (present & FIELD_AIR_HUMID) {
+            frame.raw[getFieldIndex(FIELD_AIR_HUMID)] = encodeField<FIELD_AIR_HUMID>(data.airHumid/data.airHumidCount);
+        }
+    #endif
+    #ifdef SENSOR_SOIL_TEMP_ENABLED
+        if (present & FIELD_SOIL_TEMP) {
+            frame.raw[getFieldIndex(FIELD_SOIL_TEMP)] = encodeField<FIELD_SOIL_TEMP>(data.soilTemp/data.soilTempCount);
+        }
+    #endif
+    #ifdef SENSOR_SOIL_MOISTURE_ENABLED
+        if (present & FIELD_SOIL_MOISTURE) {
+            frame.raw[getFieldIndex(FIELD_SOIL_MOISTURE)] = encodeField<FIELD_SOIL_MOISTURE>((float)data.soilMoisture/data.soilMoistureCount);
+        }
+    #endif
+    #ifdef SENSOR_LEAF_MOISTURE_ENABLED
+        if (present & FIELD_LEAF_MOISTURE) {
+            frame.raw[getFieldIndex(FIELD_LEAF_MOISTURE)] = encodeField<FIELD_LEAF_MOISTURE>((float)data.leafMoisture/data.leafMoistureCount);
+        }
+    #endif
+    #ifdef SENSOR_UV_ENABLED
+        if (present & FIELD_UV) {
+            frame.raw[getFieldIndex(FIELD_UV)] = encodeField<FIELD_UV>(convertMilliVoltsToIndex(data.uvVoltage/data.uvVoltageCount));
+        }
+    #endif
+    #ifdef SENSOR_LIGHT_ENABLED
+        if (present & FIELD_LIGHT) {
+            frame.raw[getFieldIndex(FIELD_LIGHT)] = encodeField<FIELD_LIGHT>((float)data.light/data.lightCount);
+        }
+    #endif
+    #ifdef SENSOR_WIND_SOCK_ENABLED
+        if (present & FIELD_WIND_DIR) {
+            frame.raw[getFieldIndex(FIELD_WIND_DIR)] = encodeField<FIELD_WIND_DIR>(convertVoltsToWindDirection(data.windDirVoltage/data.windDirCount));
+        }
+    #endif
+    #ifdef SENSOR_ANEMOMETER_ENABLED
+        if (present & FIELD_WIND_SPEED) {
+            frame.raw[getFieldIndex(FIELD_WIND_SPEED)] = encodeField<FIELD_WIND_SPEED>(data.windSpeed/data.windSpeedCount);
+        }
+    #endif
+    #ifdef SENSOR_PLUVIOMETER_ENABLED
+        if (present & FIELD_RAIN) {
+            frame.raw[getFieldIndex(FIELD_RAIN)] = encodeField<FIELD_RAIN>(data.pluviometerReported);
+        }
+    #endif
+    #ifdef SENSOR_PRESSURE_ENABLED
+        if (present & FIELD_PRESSURE) {
+            frame.raw[getFieldIndex(FIELD_PRESSURE)] = encodeField<FIELD_PRESSURE>((float)data.pressure/data.pressureCount);
+        }
+        if (present & FIELD_DEV_TEMP) {
+            frame.raw[getFieldIndex(FIELD_DEV_TEMP)] = encodeField<FIELD_DEV_TEMP>(data.devTemp/data.devTempCount);
+        }
+    #endif
+    #ifdef SENSOR_POWER_SUPPLY_ENABLED
+        if (present & FIELD_POWER_SUPPLY) {
+            frame.raw[getFieldIndex(FIELD_POWER_SUPPLY)] = encodeField<FIELD_POWER_SUPPLY>(data.powerSupply/data.powerSupplyCount);
+        }
+    #endif
+    if (present & FIELD_LINK_HEALTH) {
+        lora.getLinkHealth(frame.linkHealth);
+    }
+    if (present & FIELD_TIMESTAMP) {
+        frame.raw[getFieldIndex(FIELD_TIMESTAMP)] = getTimestamp(data.sampleTime);
+    }
+}
+
+/**
+ * @fn addFieldStats
+ * @brief Add a sample to the window statistics of a field (nothing is kept for fields 
+ *        without statistics in any channel).
+ * @tparam Field - field (see \ref uplink_field_e).
+ * @param[in] value - sample, in the field units.
+ */
+template <uint16_t Field, class T>
+void addFieldStats(T value) {
+    if (stats_fields & Field) {
+        fieldStats[getStatsIndex(Field)].add(encodeField<Field>(value));
+    }
+}
+
+/**
+ * @fn buildChannelStats
+ * @brief Get the window statistics of the fields of a channel.
+ * @param[in] config - uplink channel.
+ * @param[out] stats - raw values.
+ * @retval true - channel sends window statistics.
+ * @retval false - channel has no statistics.
+ */
+bool buildChannelStats(const uplink_channel_t& config, payload_stats_t& stats) {
+    bool enabled = false;
+
+    for (uint8_t k = 0; k < STAT_COUNT; k++) {
+        stats.fields[k] = config.stats[k];
+        enabled |= (config.stats[k] != 0);
+    }
+    for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+        uint16_t field = 1 << i;
+        if (!(stats_fields & field)) {
+            continue;
+        }
+        const FieldStats& fieldStat = fieldStats[getStatsIndex(field)];
+        stats.raw[STAT_MIN][i] = fieldStat.getMin();
+        stats.raw[STAT_MAX][i] = fieldStat.getMax();
+        stats.raw[STAT_STDDEV][i] = fieldStat.getStdDev();
+    }
+
+    return enabled;
+}
+
+/**
+ * @fn sendChannel
+ * @brief Build and send the frame of an uplink channel, then clear the samples of 
+ *        its fields.
+ * @details Channels with \ref uplink_channel_t::keyframe_every send delta frames against 
+ *          their last acknowledged keyframe. A keyframe (confirmed message) is sent when 
+ *          there is no acknowledged keyframe, when it is due or when a difference does 
+ *          not fit in its width.
+ * @param[in] channel - index in \ref uplink_channels.
+ */
+void sendChannel(uint8_t channel) {
+    const uplink_channel_t& config = uplink_channels[channel];
+    channel_state_t& state = channelState[channel];
+    uint8_t flags = (channelsStarted & (1 << channel)) ? 0 : PAYLOAD_FLAG_RESET;
+    uint8_t size = 0;
+    payload_stats_t stats;
+    const payload_stats_t* statsPtr = NULL;
+
+    #ifdef SENSOR_PLUVIOMETER_ENABLED
+        if (config.fields & FIELD_RAIN) {
+            noInterrupts();
+            sensorsData.pluviometerReported = sensorsData.pluviometerTurnAround;
+            interrupts();
+        }
+    #endif
+    buildChannelFrame(config.fields, sensorsData, keyframePending);
+    if (buildChannelStats(config, stats)) {
+        statsPtr = &stats;
+        flags |= PAYLOAD_FLAG_STATS;
+    }
+    channelsStarted |= (1 << channel);
+
+    // Deadbands are checked against the values sent
+    state.skipped = 0;
+    reportedFields = (reportedFields & ~config.fields) | (keyframePending.present & config.fields);
+    for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+        if (keyframePending.present & config.fields & (1 << i)) {
+            reportedRaw[i] = keyframePending.raw[i];
+        }
+    }
+    payloadPort = config.port;
+
+    if (config.keyframe_every == 0) {
+        payload[0] = getPayloadHeader(flags);
+        payloadSize = 1 + encodePayload(config.fields, keyframePending, NULL, payload + 1, statsPtr);
+        sendUplink(false);
+    } else {
+        if (state.keyframeValid && ((state.deltaCount + 1) < config.keyframe_every)) {
+            size = encodePayload(config.fields, keyframePending, &state.keyframe, payload + 2, statsPtr);
+        }
+        if (size != 0) {
+            payload[0] = getPayloadHeader(flags | PAYLOAD_FLAG_DELTA);
+            payload[1] = state.keyframeIndex;
+            payloadSize = 2 + size;
+            state.deltaCount++;
+            sendUplink(false);
+        } else {
+            payload[0] = getPayloadHeader(flags | PAYLOAD_FLAG_KEYFRAME);
+            payload[1] = state.keyframeIndex + 1;
+            payloadSize = 2 + encodePayload(config.fields, keyframePending, NULL, payload + 2, statsPtr);
+            if (sendUplink(true)) {
+                keyframeChannel = channel;
+            }
+        }
+    }
+    resetSensorData(config.fields);
+}
+
+/**
+ * @fn isReportDue
+ * @brief Check if the frame of an uplink channel must be sent (see 
+ *        \ref uplink_channel_t::heartbeat_every).
+ * @details Frame is due on the first frame, on the heartbeat, on rain or when a field 
+ *          (or its window minimum or maximum) is out of its deadband (see 
+ *          \ref field_deadbands). Fields without thresholds are not checked.
+ * @param[in] channel - index in \ref uplink_channels.
+ */
+bool isReportDue(uint8_t channel) {
+    const uplink_channel_t& config = uplink_channels[channel];
+    payload_frame_t frame;
+
+    if ((config.heartbeat_every == 0) || !(channelsStarted & (1 << channel)) || 
+        ((channelState[channel].skipped + 1) >= config.heartbeat_every)) {
+        return true;
+    }
+    #ifdef SENSOR_PLUVIOMETER_ENABLED
+        if (config.fields & FIELD_RAIN) {
+            noInterrupts();
+            bool raining = (sensorsData.pluviometerTurnAround != 0);
+            interrupts();
+            if (raining) {
+                return true;
+            }
+        }
+    #endif
+
+    buildChannelFrame(config.fields, sensorsData, frame);
+    for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+        uint16_t field = 1 << i;
+        if (!(config.fields & field) || 
+            ((field_deadbands[i].absolute == DEADBAND_OFF) && (field_deadbands[i].relative == 0))) {
+            continue;
+        }
+        if ((frame.present ^ reportedFields) & field) {
+            return true;
+        }
+        if (!(frame.present & field)) {
+            continue;
+        }
+        if (exceedsDeadband(i, frame.raw[i])) {
+            return true;
+        }
+        if ((stats_fields & field) && (exceedsDeadband(i, fieldStats[getStatsIndex(field)].getMin()) || 
+                                       exceedsDeadband(i, fieldStats[getStatsIndex(field)].getMax()))) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @fn exceedsDeadband
+ * @brief Check if a raw value is out of the deadband around the value last sent.
+ * @param[in] index - field bit position.
+ * @param[in] raw - raw value.
+ */
+bool exceedsDeadband(uint8_t index, uint16_t raw) {
+    const field_deadband_t& deadband = field_deadbands[index];
+    uint16_t last = reportedRaw[index];
+    uint16_t diff = (raw > last) ? (raw - last) : (last - raw);
+
+    return ((deadband.absolute != DEADBAND_OFF) && (diff > deadband.absolute)) ||
+           ((deadband.relative != 0) && (((uint32_t)diff * 100) > ((uint32_t)last * deadband.relative)));
+}
+
+/**
+ * @fn skipChannel
+ * @brief Drop the window of an uplink channel without sending its frame.
+ * @param[in] channel - index in \ref uplink_channels.
+ */
+void skipChannel(uint8_t channel) {
+    channelState[channel].skipped++;
+    resetSensorData(uplink_channels[channel].fields);
+
+    #ifdef SERIAL_DEBUG_ENABLED
+        SERIAL_DEBUG.print(F("\nUplink channel skipped (no change): ")); SERIAL_DEBUG.print(channel);
+        SERIAL_DEBUG.flush();
+    #endif
+}
+
+/**
+ * @fn sendUplink
+ * @brief Send the payload of the current transmission window.
+ * @details While older frames are queued, the payload is queued behind them, so windows 
+ *          are delivered in order. Payload is also queued if transmission does not start, 
+ *          unless it does not fit the current datarate (it is dropped).
+ * @param[in] confirmed - send as confirmed message (otherwise \ref LoRaConfig_t::confirm_every
+ *            applies).
+ * @retval true - transmission started.
+ * @retval false - payload queued or dropped.
+ */
+bool sendUplink(bool confirmed) {
+    if (uplinkQueue.count() == 0) {
+        uplinkKind = UPLINK_CHANNEL;
+        keyframeChannel = -1;
+        uint8_t statusCode = confirmed ? lora.sendAckMsgHex(payloadPort, payload, payloadSize) : 
+                                         lora.sendMsgHex(payloadPort, payload, payloadSize);
+        if (statusCode == LORA_STATUS_OK) {
+            return true;
+        }
+        if (statusCode == LORA_STATUS_INVALID_PARAM) {
+            #ifdef SERIAL_DEBUG_ENABLED
+                SERIAL_DEBUG.print(F("\nUplink frame dropped (larger than the LoRa payload)!"));
+                SERIAL_DEBUG.flush();
+            #endif
+            return false;
+        }
+    }
+    uplinkQueue.push(payloadPort, txWindow, payload, payloadSize);
+    return false;
+}
+
+/**
+ * @fn sendBackfill
+ * @brief Send the oldest queued frame as a confirmed message, so it is only removed 
+ *        from the queue when the network acknowledges it.
+ * @details Backfill payload layout (port \ref backfill_port):\n
+ *          2 bytes - window index (uint16)\n
+ *          2 bytes - frame age (in minutes, uint16)\n
+ *          1 byte  - original port\n
+ *          N bytes - original payload\n
+ *          Frames that no longer fit the current datarate (ADR) are dropped.
+ */
+void sendBackfill() {
+    UplinkFrame_t frame;
+    uint8_t buf[UPLINK_FRAME_SIZE + 5];
+    uint8_t size = 0;
+
+    if (!uplinkQueue.peek(frame)) {
+        return;
+    }
+    size += short2bytes(frame.window, buf + size);
+    size += short2bytes((millis() - frame.timestamp) / 60000UL, buf + size);
+    buf[size++] = frame.port;
+    memcpy(buf + size, frame.data, frame.size);
+    size += frame.size;
+
+    uint8_t statusCode = lora.sendAckMsgHex(backfill_port, buf, size);
+    if (statusCode == LORA_STATUS_OK) {
+        uplinkKind = UPLINK_BACKFILL;
+        backfillWindow = frame.window;
+    } else if (statusCode == LORA_STATUS_INVALID_PARAM) {
+        uplinkQueue.pop();
+        #ifdef SERIAL_DEBUG_ENABLED
+            SERIAL_DEBUG.print(F("\nQueued frame dropped (larger than the LoRa payload)!"));
+            SERIAL_DEBUG.flush();
+        #endif
+    }
+}
+
+/**
+ * @fn sendTimeSync
+ * @brief Send a clock synchronization request (see \ref LoRaRadio::requestTimeSync()).
+ */
+void sendTimeSync() {
+    if (lora.requestTimeSync() == LORA_STATUS_OK) {
+        uplinkKind = UPLINK_TIME_SYNC;
+    }
+}
+
+/**
+ * @fn addHistorySample
+ * @brief Append the sample just taken to the history batch. Once the batch holds 
+ *        \ref history_samples samples (or the next one would not fit), it is handed to 
+ *        \ref fragmenter (replacing a batch not completely sent). A fragment of the
+ *        replaced batch still in transmission does not move the new batch on (see
+ *        \ref loraTxCallback()).
+ * @details History batch layout (before fragmentation):\n
+ *          1 byte  - frame header (see \ref getPayloadHeader())\n
+ *          2 bytes - fields (see \ref uplink_field_e, uint16)\n
+ *          2 bytes - sampling period (in s, uint16)\n
+ *          2 bytes - timestamp of the first sample (see \ref getTimestamp())\n
+ *          N bytes - samples (presence bitmap and fields, as in channel frames)
+ * @param[in] before - sensor data before the sampling.
+ */
+void addHistorySample(const station_sensor_t& before) {
+    station_sensor_t sample = sensorsData;
+    uint8_t record[LORA_MAX_PAYLOAD_SIZE];
+    payload_frame_t frame;
+
+    diffSensorData(history_fields, sample, before);
+    #ifdef SENSOR_PLUVIOMETER_ENABLED
+        noInterrupts();
+        uint16_t total = sensorsData.pluviometerTotal;
+        interrupts();
+        sample.pluviometerReported = total - historyRainMark;
+        historyRainMark = total;
+    #endif
+    buildChannelFrame(history_fields, sample, frame);
+    uint8_t size = encodePayload(history_fields, frame, NULL, record);
+
+    if (historySize == 0) {
+        historyBlock[historySize++] = getPayloadHeader(0);
+        historySize += short2bytes(history_fields, historyBlock + historySize);
+        historySize += short2bytes(samplingPeriod / 1000, historyBlock + historySize);
+        historySize += 2;
+        historyStart = sample.sampleTime;
+    }
+    if ((historySize + size) <= history_block_size) {
+        memcpy(historyBlock + historySize, record, size);
+        historySize += size;
+        historyCount++;
+    }
+
+    if ((historyCount >= history_samples) || ((historySize + size) > history_block_size)) {
+        // Timestamp is only written now, since the clock may be synchronized meanwhile
+        short2bytes(getTimestamp(historyStart), historyBlock + 5);
+        memcpy(historyOut, historyBlock, historySize);
+        fragmentFailures = 0;
+        if (!fragmenter.begin(historyOut, historySize, lora.getMaxPayloadSize(), history_parity)) {
+            #ifdef SERIAL_DEBUG_ENABLED
+                SERIAL_DEBUG.print(F("\nHistory batch dropped!"));
+                SERIAL_DEBUG.flush();
+            #endif
+        }
+        historySize = 0;
+        historyCount = 0;
+    }
+}
+
+/**
+ * @fn sendFragment
+ * @brief Send the next fragment of the history batch as an unconfirmed message (port
+ *        \ref history_port), it only moves to the next one once transmission ends.
+ * @details Fragments are sized when the batch starts, so the batch is dropped if the 
+ *          network lowered the datarate (ADR) below the fragment size meanwhile.
+ */
+void sendFragment() {
+    uint8_t frame[LORA_MAX_PAYLOAD_SIZE];
+    uint8_t size = fragmenter.get(frame);
+
+    if (size == 0) {
+        return;
+    }
+    if (size > lora.getMaxPayloadSize()) {
+        dropFragments();
+        return;
+    }
+    if (lora.sendNoAckMsgHex(history_port, frame, size) == LORA_STATUS_OK) {
+        uplinkKind = UPLINK_FRAGMENT;
+        fragmentBatch = fragmenter.getBatch();
+    } else if (++fragmentFailures >= history_max_failures) {
+        dropFragments();
+    }
+}
+
+/**
+ * @fn dropFragments
+ * @brief Drop the history batch being sent, after \ref history_max_failures consecutive 
+ *        failures of a fragment or if it no longer fits (the reassembler drops incomplete 
+ *        batches, see \ref FragmentReassembler).
+ */
+void dropFragments() {
+    fragmentFailures = 0;
+    fragmenter.cancel();
+    #ifdef SERIAL_DEBUG_ENABLED
+        SERIAL_DEBUG.print(F("\nHistory batch dropped!"));
+        SERIAL_DEBUG.flush();
+    #endif
+}
+
+/**
+ * @fn remoteCmdHandler
+ * @brief Execute remote commands received by downlink (see \ref remote_cmd_e).
+ * @details New periods are only applied (and stored in EEPROM) if the whole downlink 
+ *          is valid and transmission period is not shorter than sampling period.
+ * @param[in] port - LoRa port.
+ * @param[in] buf - downlink payload.
+ * @param[in] size - downlink payload size.
+ */
+void remoteCmdHandler(uint8_t port, const uint8_t* buf, uint8_t size) {
+    uint32_t newSamplingPeriod = samplingPeriod;
+    uint32_t newTxPeriod = txPeriod;
+    uint8_t i = 0;
+
+    for (i = 0; (i + 3) <= size; i += 3) {
+        uint32_t value = ((uint32_t)buf[i + 1] | ((uint32_t)buf[i + 2] << 8)) * 1000;
+        if (buf[i] == REMOTE_CMD_SAMPLING_PERIOD) {
+            newSamplingPeriod = value;
+        } else if (buf[i] == REMOTE_CMD_TX_PERIOD) {
+            newTxPeriod = value;
+        } else {
+            break;
+        }
+    }
+
+    if ((i != size) || (newSamplingPeriod < systemPeriod) || (newTxPeriod < newSamplingPeriod)) {
+        #ifdef SERIAL_DEBUG_ENABLED
+            SERIAL_DEBUG.print(F("\nInvalid remote command!"));
+            SERIAL_DEBUG.flush();
+        #endif
+        return;
+    }
+
+    samplingPeriod = newSamplingPeriod;
+    txPeriod = newTxPeriod;
+    savePeriods();
+    #ifdef SERIAL_DEBUG_ENABLED
+        SERIAL_DEBUG.print(F("\nNew sampling period (in ms): ")); SERIAL_DEBUG.print(samplingPeriod);
+        SERIAL_DEBUG.print(F("\nNew transmission period (in ms): ")); SERIAL_DEBUG.print(txPeriod);
+        SERIAL_DEBUG.flush();
+    #endif
+}
+
+/**
+ * @fn loadPeriods
+ * @brief Load sampling and transmission periods from EEPROM (keep defaults if there 
+ *        is no valid record).
+ */
+void loadPeriods() {
+    periods_record_t record;
+    EEPROM.get(EEPROM_PERIODS_ADDR, record);
+    if ((record.magic == PERIODS_EEPROM_MAGIC) && (record.samplingPeriod >= systemPeriod) && 
+        (record.txPeriod >= record.samplingPeriod)) {
+        samplingPeriod = record.samplingPeriod;
+        txPeriod = record.txPeriod;
+    }
+}
+
+/**
+ * @fn savePeriods
+ * @brief Store sampling and transmission periods in EEPROM.
+ */
+void savePeriods() {
+    periods_record_t record;
+    record.magic = PERIODS_EEPROM_MAGIC;
+    record.samplingPeriod = samplingPeriod;
+    record.txPeriod = txPeriod;
+    EEPROM.put(EEPROM_PERIODS_ADDR, record);
+}
+
+/**
+ * @fn resetSensorData
+ * @brief Clear the samples (and window statistics) of the selected fields (see 
+ *        \ref uplink_field_e).
+ * @param[in] fields - fields bit mask.
+ */
+void resetSensorData(uint16_t fields) {
+    for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+        if (fields & stats_fields & (1 << i)) {
+            fieldStats[getStatsIndex(1 << i)].reset();
+        }
+    }
     #ifdef SENSOR_DHT_ENABLED
-        sensorsData.airTemp = 0.0f;
-        sensorsData.airTempCount = 0;
-        sensorsData.airHumid = 0.0f;
-        sensorsData.airHumidCount = 0;
+        if (fields & FIELD_AIR_TEMP) {
+            sensorsData.airTemp = 0.0f;
+            sensorsData.airTempCount = 0;
+        }
+        if (fields & FIELD_AIR_HUMID) {
+            sensorsData.airHumid = 0.0f;
+            sensorsData.airHumidCount = 0;
+        }
     #endif
     #ifdef SENSOR_LIGHT_ENABLED
-        sensorsData.light = 0;
-        sensorsData.lightCount = 0;
+        if (fields & FIELD_LIGHT) {
+            sensorsData.light = 0;
+            sensorsData.lightCount = 0;
+        }
     #endif
     #ifdef SENSOR_UV_ENABLED
-        sensorsData.uvVoltage = 0;
-        sensorsData.uvVoltageCount = 0;
+        if (fields & FIELD_UV) {
+            sensorsData.uvVoltage = 0;
+            sensorsData.uvVoltageCount = 0;
+        }
     #endif    
     #ifdef SENSOR_SOIL_TEMP_ENABLED
-        sensorsData.soilTemp = 0.0f;
-        sensorsData.soilTempCount = 0;
+        if (fields & FIELD_SOIL_TEMP) {
+            sensorsData.soilTemp = 0.0f;
+            sensorsData.soilTempCount = 0;
+        }
     #endif
     #ifdef SENSOR_SOIL_MOISTURE_ENABLED
-        sensorsData.soilMoisture = 0;
-        sensorsData.soilMoistureCount = 0;
+        if (fields & FIELD_SOIL_MOISTURE) {
+            sensorsData.soilMoisture = 0;
+            sensorsData.soilMoistureCount = 0;
+        }
     #endif    
     #ifdef SENSOR_LEAF_MOISTURE_ENABLED
-        sensorsData.leafMoisture = 0;
-        sensorsData.leafMoistureCount = 0;
+        if (fields & FIELD_LEAF_MOISTURE) {
+            sensorsData.leafMoisture = 0;
+            sensorsData.leafMoistureCount = 0;
+        }
     #endif
     #ifdef SENSOR_WIND_SOCK_ENABLED
-        sensorsData.windDirVoltage = 0.0f;
-        sensorsData.windDirCount = 0;
+        if (fields & FIELD_WIND_DIR) {
+            sensorsData.windDirVoltage = 0.0f;
+            sensorsData.windDirCount = 0;
+        }
     #endif
     #ifdef SENSOR_ANEMOMETER_ENABLED
-        sensorsData.windSpeed = 0.0f;        
-        sensorsData.windSpeedCount = 0;        
+        if (fields & FIELD_WIND_SPEED) {
+            sensorsData.windSpeed = 0.0f;        
+            sensorsData.windSpeedCount = 0;        
+        }
     #endif
     #ifdef SENSOR_PLUVIOMETER_ENABLED
-        sensorsData.rainVolume = 0;            
+        if (fields & FIELD_RAIN) {
+            // Keep turn arounds counted after the payload was built
+            noInterrupts();
+            sensorsData.pluviometerTurnAround -= sensorsData.pluviometerReported;
+            interrupts();
+            sensorsData.pluviometerReported = 0;
+            sensorsData.rainVolume = 0;            
+        }
     #endif
     #ifdef SENSOR_POWER_SUPPLY_ENABLED
-        sensorsData.powerSupply = 0.0f;
-        sensorsData.powerSupplyCount = 0;       
+        if (fields & FIELD_POWER_SUPPLY) {
+            sensorsData.powerSupply = 0.0f;
+            sensorsData.powerSupplyCount = 0;       
+        }
     #endif
     #ifdef SENSOR_PRESSURE_ENABLED
-        sensorsData.pressure = 0;
-        sensorsData.pressureCount = 0;
-        sensorsData.devTemp = 0.0f;
-        sensorsData.devTempCount = 0;
+        if (fields & FIELD_PRESSURE) {
+            sensorsData.pressure = 0;
+            sensorsData.pressureCount = 0;
+        }
+        if (fields & FIELD_DEV_TEMP) {
+            sensorsData.devTemp = 0.0f;
+            sensorsData.devTempCount = 0;
+        }
+    #endif
+}
+
+
+/**
+ * @fn diffSensorData
+ * @brief Keep only the samples taken after \p before in the selected fields (see 
+ *        \ref uplink_field_e), so \ref buildChannelFrame() gets a single sample.
+ * @details Rain is not handled, since its turn arounds are not sampled.
+ * @param[in] fields - fields bit mask.
+ * @param[in,out] data - sensor data after the sampling.
+ * @param[in] before - sensor data before the sampling.
+ */
+void diffSensorData(uint16_t fields, station_sensor_t& data, const station_sensor_t& before) {
+    #ifdef SENSOR_DHT_ENABLED
+        if (fields & FIELD_AIR_TEMP) {
+            data.airTemp -= before.airTemp;
+            data.airTempCount -= before.airTempCount;
+        }
+        if (fields & FIELD_AIR_HUMID) {
+            data.airHumid -= before.airHumid;
+            data.airHumidCount -= before.airHumidCount;
+        }
+    #endif
+    #ifdef SENSOR_LIGHT_ENABLED
+        if (fields & FIELD_LIGHT) {
+            data.light -= before.light;
+            data.lightCount -= before.lightCount;
+        }
+    #endif
+    #ifdef SENSOR_UV_ENABLED
+        if (fields & FIELD_UV) {
+            data.uvVoltage -= before.uvVoltage;
+            data.uvVoltageCount -= before.uvVoltageCount;
+        }
+    #endif
+    #ifdef SENSOR_SOIL_TEMP_ENABLED
+        if (fields & FIELD_SOIL_TEMP) {
+            data.soilTemp -= before.soilTemp;
+            data.soilTempCount -= before.soilTempCount;
+        }
+    #endif
+    #ifdef SENSOR_SOIL_MOISTURE_ENABLED
+        if (fields & FIELD_SOIL_MOISTURE) {
+            data.soilMoisture -= before.soilMoisture;
+            data.soilMoistureCount -= before.soilMoistureCount;
+        }
+    #endif
+    #ifdef SENSOR_LEAF_MOISTURE_ENABLED
+        if (fields & FIELD_LEAF_MOISTURE) {
+            data.leafMoisture -= before.leafMoisture;
+            data.leafMoistureCount -= before.leafMoistureCount;
+        }
+    #endif
+    #ifdef SENSOR_WIND_SOCK_ENABLED
+        if (fields & FIELD_WIND_DIR) {
+            data.windDirVoltage -= before.windDirVoltage;
+            data.windDirCount -= before.windDirCount;
+        }
+    #endif
+    #ifdef SENSOR_ANEMOMETER_ENABLED
+        if (fields & FIELD_WIND_SPEED) {
+            data.windSpeed -= before.windSpeed;
+            data.windSpeedCount -= before.windSpeedCount;
+        }
+    #endif
+    #ifdef SENSOR_POWER_SUPPLY_ENABLED
+        if (fields & FIELD_POWER_SUPPLY) {
+            data.powerSupply -= before.powerSupply;
+            data.powerSupplyCount -= before.powerSupplyCount;
+        }
+    #endif
+    #ifdef SENSOR_PRESSURE_ENABLED
+        if (fields & FIELD_PRESSURE) {
+            data.pressure -= before.pressure;
+            data.pressureCount -= before.pressureCount;
+        }
+        if (fields & FIELD_DEV_TEMP) {
+            data.devTemp -= before.devTemp;
+            data.devTempCount -= before.devTempCount;
+        }
     #endif
 }
 
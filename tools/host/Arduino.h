@@ -0,0 +1,488 @@
+/**
+ * @file Arduino.h
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Minimal host shim of the Arduino core, so the LoRa driver and the convert
+ *        tools build with a desktop C++11 compiler (benchmarks in tools/host).
+ * @details Only the parts used by include/LoRa.h, include/RHF76.h and
+ *          include/convert_tools.h are provided. String follows the Arduino WString
+ *          implementation (one exactly sized heap buffer, grown by realloc() on every
+ *          concat() and numbers converted by utoa()/ultoa()), so its cost is close
+ *          to the AVR one in relative terms.\n
+ *          millis()/micros() follow the host clock, and delay() only moves them
+ *          forward, so benchmarks do not sleep.
+ * @version alpha
+ * @since 17/10/2026
+ * @date 17/10/2026
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __HOST_ARDUINO_H__
+#define __HOST_ARDUINO_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <math.h>
+#include <chrono>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HEX 16
+#define DEC 10
+
+#define PROGMEM
+#define PSTR(s) (s)
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(PSTR(s)))
+
+#define lowByte(w) ((uint8_t)((w) & 0xff))
+#define highByte(w) ((uint8_t)((w) >> 8))
+
+
+/*******************************************************
+ *                      TIME
+ *******************************************************/
+
+/**
+ * @fn hostDelayOffset
+ * @brief Time (in us) added to the host clock by \ref delay().
+ */
+inline uint64_t& hostDelayOffset() {
+    static uint64_t offset = 0;
+    return offset;
+}
+
+inline uint64_t hostMicros() {
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    uint64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    return elapsed + hostDelayOffset();
+}
+
+inline unsigned long micros() {
+    return (unsigned long)hostMicros();
+}
+
+inline unsigned long millis() {
+    return (unsigned long)(hostMicros() / 1000);
+}
+
+inline void delay(unsigned long ms) {
+    hostDelayOffset() += (uint64_t)ms * 1000;
+}
+
+inline void delayMicroseconds(unsigned int us) {
+    hostDelayOffset() += us;
+}
+
+
+/*******************************************************
+ *                 NUMBERS AND RANDOM
+ *******************************************************/
+
+inline char* ultoa(unsigned long value, char* buf, int base) {
+    char digits[8 * sizeof(unsigned long) + 1];
+    uint8_t n = 0;
+
+    do {
+        uint8_t digit = value % base;
+        digits[n++] = (digit < 10) ? ('0' + digit) : ('a' + digit - 10);
+        value /= base;
+    } while (value != 0);
+
+    for (uint8_t i = 0; i < n; i++) {
+        buf[i] = digits[n - 1 - i];
+    }
+    buf[n] = '\0';
+
+    return buf;
+}
+
+inline char* ltoa(long value, char* buf, int base) {
+    if ((value < 0) && (base == 10)) {
+        buf[0] = '-';
+        ultoa(-(unsigned long)value, buf + 1, base);
+        return buf;
+    }
+    return ultoa((unsigned long)value, buf, base);
+}
+
+inline char* utoa(unsigned int value, char* buf, int base) {
+    return ultoa(value, buf, base);
+}
+
+inline char* itoa(int value, char* buf, int base) {
+    return ltoa(value, buf, base);
+}
+
+inline void randomSeed(unsigned long seed) {
+    srand(seed);
+}
+
+inline long random(long howbig) {
+    return (howbig == 0) ? 0 : rand() % howbig;
+}
+
+inline long random(long howsmall, long howbig) {
+    return (howsmall >= howbig) ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+
+/*******************************************************
+ *                      STRING
+ *******************************************************/
+
+/**
+ * @class String
+ * @brief Arduino WString: heap buffer sized to its content.
+ */
+class String {
+    private:
+        char* buffer = NULL;
+        unsigned int capacity = 0;
+        unsigned int len = 0;
+
+        bool changeBuffer(unsigned int maxStrLen) {
+            char* newbuffer = (char*)realloc(this->buffer, maxStrLen + 1);
+            if (newbuffer == NULL) {
+                return false;
+            }
+            this->buffer = newbuffer;
+            this->capacity = maxStrLen;
+            return true;
+        }
+
+        String& copy(const char* cstr, unsigned int length) {
+            if (!reserve(length)) {
+                invalidate();
+                return *this;
+            }
+            this->len = length;
+            memcpy(this->buffer, cstr, length);
+            this->buffer[length] = '\0';
+            return *this;
+        }
+
+        void move(String& rhs) {
+            free(this->buffer);
+            this->buffer = rhs.buffer;
+            this->capacity = rhs.capacity;
+            this->len = rhs.len;
+            rhs.buffer = NULL;
+            rhs.capacity = 0;
+            rhs.len = 0;
+        }
+
+        void invalidate() {
+            free(this->buffer);
+            this->buffer = NULL;
+            this->capacity = 0;
+            this->len = 0;
+        }
+
+    public:
+        String(const char* cstr = "") {
+            if (cstr != NULL) {
+                copy(cstr, strlen(cstr));
+            }
+        }
+        String(const __FlashStringHelper* str) : String(reinterpret_cast<const char*>(str)) {}
+        String(const String& value) {
+            *this = value;
+        }
+        String(String&& rval) {
+            move(rval);
+        }
+        explicit String(char c) {
+            char buf[2] = {c, '\0'};
+            *this = buf;
+        }
+        explicit String(unsigned char value, unsigned char base = 10) {
+            char buf[1 + 8 * sizeof(unsigned char)];
+            utoa(value, buf, base);
+            *this = buf;
+        }
+        explicit String(int value, unsigned char base = 10) {
+            char buf[2 + 8 * sizeof(int)];
+            itoa(value, buf, base);
+            *this = buf;
+        }
+        explicit String(unsigned int value, unsigned char base = 10) {
+            char buf[1 + 8 * sizeof(unsigned int)];
+            utoa(value, buf, base);
+            *this = buf;
+        }
+        explicit String(long value, unsigned char base = 10) {
+            char buf[2 + 8 * sizeof(long)];
+            ltoa(value, buf, base);
+            *this = buf;
+        }
+        explicit String(unsigned long value, unsigned char base = 10) {
+            char buf[1 + 8 * sizeof(unsigned long)];
+            ultoa(value, buf, base);
+            *this = buf;
+        }
+        explicit String(double value, unsigned char decimalPlaces = 2) {
+            char buf[33];
+            snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+            *this = buf;
+        }
+        ~String() {
+            free(this->buffer);
+        }
+
+        bool reserve(unsigned int size) {
+            if ((this->buffer != NULL) && (this->capacity >= size)) {
+                return true;
+            }
+            if (changeBuffer(size)) {
+                if (this->len == 0) {
+                    this->buffer[0] = '\0';
+                }
+                return true;
+            }
+            return false;
+        }
+
+        String& operator=(const String& rhs) {
+            if (this == &rhs) {
+                return *this;
+            }
+            if (rhs.buffer != NULL) {
+                copy(rhs.buffer, rhs.len);
+            } else {
+                invalidate();
+            }
+            return *this;
+        }
+        String& operator=(String&& rval) {
+            if (this != &rval) {
+                move(rval);
+            }
+            return *this;
+        }
+        String& operator=(const char* cstr) {
+            if (cstr != NULL) {
+                copy(cstr, strlen(cstr));
+            } else {
+                invalidate();
+            }
+            return *this;
+        }
+
+        bool concat(const char* cstr, unsigned int length) {
+            unsigned int newlen = this->len + length;
+            if (cstr == NULL) {
+                return false;
+            }
+            if (length == 0) {
+                return true;
+            }
+            if (!reserve(newlen)) {
+                return false;
+            }
+            memcpy(this->buffer + this->len, cstr, length);
+            this->len = newlen;
+            this->buffer[newlen] = '\0';
+            return true;
+        }
+        bool concat(const String& str) {
+            return concat(str.buffer, str.len);
+        }
+        bool concat(const char* cstr) {
+            return (cstr != NULL) && concat(cstr, strlen(cstr));
+        }
+        bool concat(const __FlashStringHelper* str) {
+            return concat(reinterpret_cast<const char*>(str));
+        }
+        bool concat(char c) {
+            return concat(&c, 1);
+        }
+        bool concat(unsigned char num) {
+            char buf[1 + 3 * sizeof(unsigned char)];
+            return concat(utoa(num, buf, 10));
+        }
+        bool concat(int num) {
+            char buf[2 + 3 * sizeof(int)];
+            return concat(itoa(num, buf, 10));
+        }
+        bool concat(unsigned int num) {
+            char buf[1 + 3 * sizeof(unsigned int)];
+            return concat(utoa(num, buf, 10));
+        }
+        bool concat(long num) {
+            char buf[2 + 3 * sizeof(long)];
+            return concat(ltoa(num, buf, 10));
+        }
+        bool concat(unsigned long num) {
+            char buf[1 + 3 * sizeof(unsigned long)];
+            return concat(ultoa(num, buf, 10));
+        }
+        template <class T> String& operator+=(const T& rhs) {
+            concat(rhs);
+            return *this;
+        }
+        friend String operator+(const String& lhs, const String& rhs) {
+            String sum(lhs);
+            sum.concat(rhs);
+            return sum;
+        }
+
+        int compareTo(const String& s) const {
+            if ((this->buffer == NULL) || (s.buffer == NULL)) {
+                if ((s.buffer != NULL) && (s.len > 0)) {
+                    return 0 - *(unsigned char*)s.buffer;
+                }
+                if ((this->buffer != NULL) && (this->len > 0)) {
+                    return *(unsigned char*)this->buffer;
+                }
+                return 0;
+            }
+            return strcmp(this->buffer, s.buffer);
+        }
+        bool equals(const String& s) const {
+            return (this->len == s.len) && (compareTo(s) == 0);
+        }
+        bool operator==(const String& rhs) const {
+            return equals(rhs);
+        }
+        bool operator!=(const String& rhs) const {
+            return !equals(rhs);
+        }
+
+        unsigned int length() const {
+            return this->len;
+        }
+        const char* c_str() const {
+            return (this->buffer != NULL) ? this->buffer : "";
+        }
+        char charAt(unsigned int index) const {
+            return (index < this->len) ? this->buffer[index] : '\0';
+        }
+        char operator[](unsigned int index) const {
+            return charAt(index);
+        }
+        void toCharArray(char* buf, unsigned int bufsize, unsigned int index = 0) const {
+            if ((bufsize == 0) || (buf == NULL)) {
+                return;
+            }
+            if (index >= this->len) {
+                buf[0] = '\0';
+                return;
+            }
+            unsigned int n = bufsize - 1;
+            if (n > this->len - index) {
+                n = this->len - index;
+            }
+            memcpy(buf, this->buffer + index, n);
+            buf[n] = '\0';
+        }
+        long toInt() const {
+            return (this->buffer != NULL) ? atol(this->buffer) : 0;
+        }
+};
+
+
+/*******************************************************
+ *                   PRINT AND STREAM
+ *******************************************************/
+
+/**
+ * @class Print
+ * @brief Arduino Print: text output over write(uint8_t).
+ */
+class Print {
+    private:
+        size_t printNumber(unsigned long n, uint8_t base) {
+            char buf[8 * sizeof(long) + 1];
+            return write(ultoa(n, buf, (base < 2) ? 10 : base));
+        }
+
+    public:
+        virtual ~Print() {}
+        virtual size_t write(uint8_t) = 0;
+        virtual size_t write(const uint8_t* buffer, size_t size) {
+            size_t n = 0;
+            while (size--) {
+                if (write(*buffer++)) {
+                    n++;
+                } else {
+                    break;
+                }
+            }
+            return n;
+        }
+        size_t write(const char* str) {
+            return (str == NULL) ? 0 : write((const uint8_t*)str, strlen(str));
+        }
+        size_t write(const char* buffer, size_t size) {
+            return write((const uint8_t*)buffer, size);
+        }
+        virtual void flush() {}
+
+        size_t print(const __FlashStringHelper* ifsh) {
+            return write(reinterpret_cast<const char*>(ifsh));
+        }
+        size_t print(const String& s) {
+            return write(s.c_str(), s.length());
+        }
+        size_t print(const char* str) {
+            return write(str);
+        }
+        size_t print(char c) {
+            return write((uint8_t)c);
+        }
+        size_t print(unsigned char n, int base = DEC) {
+            return printNumber(n, base);
+        }
+        size_t print(unsigned int n, int base = DEC) {
+            return printNumber(n, base);
+        }
+        size_t print(unsigned long n, int base = DEC) {
+            return printNumber(n, base);
+        }
+        size_t print(int n, int base = DEC) {
+            return print((long)n, base);
+        }
+        size_t print(long n, int base = DEC) {
+            if ((n < 0) && (base == DEC)) {
+                return print('-') + printNumber(-(unsigned long)n, base);
+            }
+            return printNumber(n, base);
+        }
+        size_t print(double n, int digits = 2) {
+            char buf[33];
+            snprintf(buf, sizeof(buf), "%.*f", digits, n);
+            return write(buf);
+        }
+        template <class T> size_t println(T value) {
+            return print(value) + write("\r\n");
+        }
+        size_t println() {
+            return write("\r\n");
+        }
+};
+
+/**
+ * @class Stream
+ * @brief Arduino Stream: Print with input.
+ */
+class Stream : public Print {
+    public:
+        virtual int available() = 0;
+        virtual int read() = 0;
+        virtual int peek() = 0;
+};
+
+#endif // __HOST_ARDUINO_H__
@@ -0,0 +1,75 @@
+/**
+ * @file EEPROM.h
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Host shim of the Arduino EEPROM library (ATmega2560 size, erased to 0xFF).
+ * @version alpha
+ * @since 17/10/2026
+ * @date 17/10/2026
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __HOST_EEPROM_H__
+#define __HOST_EEPROM_H__
+
+#include <Arduino.h>
+
+#define HOST_EEPROM_SIZE    4096
+
+/**
+ * @class EEPROMClass
+ * @brief EEPROM kept in a RAM array.
+ */
+class EEPROMClass {
+    private:
+        uint8_t mem[HOST_EEPROM_SIZE];
+
+    public:
+        EEPROMClass() {
+            erase();
+        }
+
+        /**
+         * @fn EEPROMClass::erase()
+         * @brief Erase the whole EEPROM (host only, like a new board).
+         */
+        void erase() {
+            memset(this->mem, 0xFF, sizeof(this->mem));
+        }
+
+        uint8_t read(int idx) {
+            return this->mem[idx];
+        }
+
+        void write(int idx, uint8_t val) {
+            this->mem[idx] = val;
+        }
+
+        void update(int idx, uint8_t val) {
+            this->mem[idx] = val;
+        }
+
+        template <typename T> T& get(int idx, T& t) {
+            memcpy((void*)&t, this->mem + idx, sizeof(T));
+            return t;
+        }
+
+        template <typename T> const T& put(int idx, const T& t) {
+            memcpy(this->mem + idx, (const void*)&t, sizeof(T));
+            return t;
+        }
+
+        uint16_t length() {
+            return HOST_EEPROM_SIZE;
+        }
+};
+
+// Single translation unit builds only (like the benchmarks in tools/host)
+static EEPROMClass EEPROM;
+
+#endif // __HOST_EEPROM_H__
@@ -0,0 +1,198 @@
+/**
+ * @file FakeTransport.h
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Host fake of the RHF76 modem UART, plugged in the Transport parameter of
+ *        \ref RHF76 (see \ref lora_bench.cpp).
+ * @details Every AT command written by the driver is answered at once, with the lines
+ *          of a RHF76 firmware: settings are kept, so queries answer what was set
+ *          (e.g. "AT+ID=DevEui" after "AT+ID=DevEui,\"...\""), "AT+LW=ULDL" reports
+ *          frame counters and message commands end with their "Done" line. Preamble
+ *          bytes (0xFF) sent to wake the modem are ignored.
+ * @version alpha
+ * @since 17/10/2026
+ * @date 17/10/2026
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __FAKE_TRANSPORT_H__
+#define __FAKE_TRANSPORT_H__
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+
+/**
+ * @class FakeTransport
+ * @brief Scripted RHF76 modem behind a Stream.
+ */
+class FakeTransport : public Stream {
+    private:
+        bool opened = false;
+        std::string line;                               // Command being written by the driver
+        std::string rx;                                 // Lines not yet read by the driver
+        size_t rxPos = 0;
+        std::map<std::string, std::string> settings;    // Last value of every setting
+        uint32_t uplink = 0;
+        uint32_t downlink = 0;
+
+        void reply(const std::string& name, const std::string& text) {
+            this->rx += "+" + name + ": " + text + "\r\n";
+        }
+
+        static std::string unquote(std::string value) {
+            size_t first = value.find_first_not_of(" \"");
+            size_t last = value.find_last_not_of(" \"");
+
+            return (first == std::string::npos) ? "" : value.substr(first, last - first + 1);
+        }
+
+        void execute(const std::string& cmd) {
+            this->commands++;
+            this->sleeping = false;
+            if (cmd == "AT") {
+                reply("AT", "OK");
+                return;
+            }
+            if (cmd.compare(0, 3, "AT+") != 0) {
+                reply("AT", "ERROR(-1)");
+                return;
+            }
+
+            size_t equal = cmd.find('=');
+            std::string name = cmd.substr(3, equal - 3);
+            std::string args = (equal == std::string::npos) ? "" : cmd.substr(equal + 1);
+            this->calls[name]++;
+
+            if ((name == "MSGHEX") || (name == "CMSGHEX")) {
+                this->uplink++;
+                this->payloadDigits += unquote(args).size();
+                reply(name, "Start");
+                if (name == "CMSGHEX") {
+                    reply(name, "Wait ACK");
+                    reply(name, "ACK Received");
+                    this->downlink++;
+                }
+                reply(name, "RXWIN1, RSSI -106, SNR 4.0");
+                reply(name, "Done");
+            } else if ((name == "JOIN") && (this->joinFailures != 0)) {
+                this->joinFailures--;
+                reply(name, "Starting");
+                reply(name, "Join failed");
+                reply(name, "Done");
+            } else if (name == "JOIN") {
+                reply(name, "Starting");
+                reply(name, "Network joined");
+                reply(name, "NetID 000013 DevAddr 26:01:5F:66");
+                reply(name, "Done");
+                this->settings["ID=DevAddr"] = "26:01:5F:66";
+            } else if (name == "LW") {
+                if (args.compare(0, 4, "ULDL") == 0) {
+                    if (args.size() > 4) {
+                        char* next = NULL;
+                        this->uplink = strtoul(args.c_str() + 5, &next, 10);
+                        this->downlink = strtoul(next + 1, NULL, 10);
+                    }
+                    reply(name, "ULDL, " + std::to_string(this->uplink) + ", " + std::to_string(this->downlink));
+                } else {
+                    reply(name, args);
+                }
+            } else if ((name == "ID") || (name == "KEY")) {
+                size_t comma = args.find(',');
+                std::string id = args.substr(0, comma);
+                if (comma != std::string::npos) {
+                    this->settings[name + "=" + id] = unquote(args.substr(comma + 1));
+                }
+                reply(name, id + ", " + this->settings[name + "=" + id]);
+            } else if (name == "DR") {
+                if (args.compare(0, 2, "DR") == 0) {
+                    this->settings[name] = args;
+                }
+                reply(name, args.empty() ? (this->settings.count(name) ? this->settings[name] : "DR0") : args);
+            } else if (name == "VER") {
+                reply(name, "2.0.10");
+            } else if (name == "LOWPOWER") {
+                reply(name, "SLEEP");
+                this->sleeping = true;
+            } else if (args.empty()) {
+                reply(name, this->settings.count(name) ? this->settings[name] : "OK");
+            } else {
+                this->settings[name] = args;
+                reply(name, args);
+            }
+        }
+
+    public:
+        uint32_t commands = 0;          /**< AT commands received. */
+        uint32_t bytesWritten = 0;      /**< Bytes written by the driver. */
+        uint32_t payloadDigits = 0;     /**< Hex digits of the messages sent. */
+        std::map<std::string, uint32_t> calls;  /**< Commands received, by name ("LW", "DR"...). */
+        uint8_t joinFailures = 0;       /**< Number of next joins refused. */
+        bool sleeping = false;          /**< Modem in low power mode (until a command arrives). */
+
+        void begin(unsigned long) {
+            this->opened = true;
+        }
+
+        void end() {
+            this->opened = false;
+        }
+
+        operator bool() {
+            return this->opened;
+        }
+
+        /**
+         * @fn FakeTransport::factoryReset()
+         * @brief Drop the settings and counters held by the modem.
+         */
+        void factoryReset() {
+            this->settings.clear();
+            this->uplink = 0;
+            this->downlink = 0;
+        }
+
+        int available() override {
+            return this->rx.size() - this->rxPos;
+        }
+
+        int read() override {
+            if (this->rxPos >= this->rx.size()) {
+                return -1;
+            }
+            int c = (uint8_t)this->rx[this->rxPos++];
+            if (this->rxPos == this->rx.size()) {
+                this->rx.clear();
+                this->rxPos = 0;
+            }
+            return c;
+        }
+
+        int peek() override {
+            return (this->rxPos < this->rx.size()) ? (uint8_t)this->rx[this->rxPos] : -1;
+        }
+
+        size_t write(uint8_t c) override {
+            this->bytesWritten++;
+            if (c == 0xFF) {
+                return 1;
+            }
+            if (c == '\n') {
+                if (!this->line.empty()) {
+                    execute(this->line);
+                }
+                this->line.clear();
+            } else if (c != '\r') {
+                this->line += (char)c;
+            }
+            return 1;
+        }
+        using Print::write;
+};
+
+#endif // __FAKE_TRANSPORT_H__
@@ -0,0 +1,93 @@
+/**
+ * @file fixed_test.cpp
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Host test of the fixed point converters (\ref to_fixed() and \ref from_fixed()).
+ * @details Build and run from the repository root (or run tools/host/run_tests.sh):\n
+ *          g++ -std=gnu++11 -O2 -Itools/host -Iinclude tools/host/fixed_test.cpp -o fixed_test && ./fixed_test
+ * @version alpha
+ * @since 17/10/2026
+ * @date 17/10/2026
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#include <stdio.h>
+#include <math.h>
+#include "FixedPoint.h"
+#include "host_test.h"
+
+/**
+ * @fn reference
+ * @brief Expected field value: round half away from zero of value * scale / divisor,
+ *        limited to [min, max].
+ */
+static int32_t reference(double value, double scale, double divisor, int32_t min, int32_t max) {
+    double scaled = value * scale / divisor;
+    scaled = (scaled >= 0.0) ? floor(scaled + 0.5) : -floor(-scaled + 0.5);
+
+    return (scaled > max) ? max : ((scaled < min) ? min : (int32_t)scaled);
+}
+
+// Integer values are rounded and saturated, even when the product would overflow
+static void testInteger() {
+    static const int32_t EDGES[] = {-2147483647L - 1, -100000L, -32769L, -32768L, -2048L, -1L, 0, 1L,
+                                    2047L, 32767L, 32768L, 65535L, 65536L, 100000L, 2147483647L};
+
+    for (uint8_t i = 0; i < sizeof(EDGES) / sizeof(EDGES[0]); i++) {
+        int32_t value = EDGES[i];
+        CHECK(to_fixed<16, 1>(value) == reference(value, 1, 1, 0, 65535));
+        CHECK(to_fixed<16, 100>(value) == reference(value, 100, 1, 0, 65535));
+        CHECK(from_fixed<12, true>(to_fixed<12, 1, true>(value)) == reference(value, 1, 1, -2048, 2047));
+        CHECK(from_fixed<16, true>(to_fixed<16, 10, true>(value)) == reference(value, 10, 1, -32768, 32767));
+        CHECK(to_fixed<3, 1, false, 45>(value) == reference(value, 1, 45, 0, 7));
+    }
+    for (int32_t value = -1000; value <= 1000; value++) {
+        CHECK(to_fixed<3, 1, false, 45>(value) == reference(value, 1, 45, 0, 7));
+        CHECK(from_fixed<8, true>(to_fixed<8, 1, true, 3>(value)) == reference(value, 1, 3, -128, 127));
+        CHECK(to_fixed<11, 10>((int16_t)value) == reference(value, 10, 1, 0, 2047));
+    }
+}
+
+// Floating point values are rounded and saturated, NaN is converted to 0
+static void testFloat() {
+    for (int32_t i = -300000; i <= 300000; i += 7) {
+        float value = i / 1000.0f;
+        // Halfway values (e.g. 12.35) are not exact in float, see the exact ones below
+        if ((i % 5) == 0) {
+            continue;
+        }
+        CHECK(to_fixed<11, 10>(value) == reference(value, 10, 1, 0, 2047));
+        CHECK(from_fixed<11, true>(to_fixed<11, 10, true>(value)) == reference(value, 10, 1, -1024, 1023));
+        CHECK(to_fixed<16, 100>(value) == reference(value, 100, 1, 0, 65535));
+    }
+    CHECK(to_fixed<11, 10>(2.25f) == 23);
+    CHECK(from_fixed<11, true>(to_fixed<11, 10, true>(-2.25f)) == -23);
+    CHECK(to_fixed<16, 100>(700.0f) == 65535);
+    CHECK(to_fixed<16, 100>(1e30f) == 65535);
+    CHECK(from_fixed<16, true>(to_fixed<16, 100, true>(-1e30f)) == -32768);
+    CHECK(to_fixed<16, 1>(NAN) == 0);
+    CHECK(to_fixed<8, 1, true>(NAN) == 0);
+}
+
+// Signed fields are two's complement within their width
+static void testSigned() {
+    CHECK(to_fixed<8, 1, true>(-3) == 0xFD);
+    CHECK(from_fixed<8, true>(0xFD) == -3);
+    CHECK(from_fixed<8, true>(to_fixed<8, 1, true>(-300)) == -128);
+    CHECK(from_fixed<8, true>(to_fixed<8, 1, true>(300)) == 127);
+    CHECK(from_fixed<8, false>(0xFD) == 0xFD);
+    CHECK(from_fixed<4, true>(0xFFF8) == -8);
+}
+
+int main() {
+    testInteger();
+    testFloat();
+    testSigned();
+
+    return hostTestResult("fixed_test");
+}
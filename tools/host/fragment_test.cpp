@@ -0,0 +1,195 @@
+/**
+ * @file fragment_test.cpp
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Host test of \ref Fragmenter and \ref FragmentReassembler.
+ * @details Build and run from the repository root (or run tools/host/run_tests.sh):\n
+ *          g++ -std=gnu++11 -O2 -Itools/host -Iinclude tools/host/fragment_test.cpp -o fragment_test && ./fragment_test
+ * @version alpha
+ * @since 17/10/2026
+ * @date 17/10/2026
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "Fragment.h"
+#include "host_test.h"
+
+#define TEST_MAX_BLOCK      400
+#define TEST_MAX_PAYLOAD    222
+#define TEST_MAX_FRAMES     (FRAGMENT_MAX_COUNT + 1)
+
+typedef FragmentReassembler<FRAGMENT_MAX_COUNT, TEST_MAX_PAYLOAD - FRAGMENT_HEADER_SIZE, 4> Reassembler;
+
+/**
+ * @struct Batch_t
+ * @brief Fragments of a block, as sent by the station.
+ */
+struct Batch_t {
+    uint8_t frames[TEST_MAX_FRAMES][TEST_MAX_PAYLOAD];
+    uint8_t sizes[TEST_MAX_FRAMES];
+    uint8_t count;
+};
+
+static void fillBlock(uint8_t* block, uint16_t size) {
+    for (uint16_t i = 0; i < size; i++) {
+        block[i] = (uint8_t)rand();
+    }
+}
+
+static void split(Fragmenter& fragmenter, Batch_t& batch) {
+    batch.count = 0;
+    while (fragmenter.pending()) {
+        batch.sizes[batch.count] = fragmenter.get(batch.frames[batch.count]);
+        batch.count++;
+        fragmenter.next();
+    }
+}
+
+/**
+ * @fn deliver
+ * @brief Feed fragments in \p order (skipping \p lost ones) and count delivered blocks.
+ * @return uint8_t - number of blocks delivered (each must match \p block).
+ */
+static uint8_t deliver(Reassembler& reassembler, const Batch_t& batch, const uint8_t* order,
+                       const bool* lost, const uint8_t* block, uint16_t size) {
+    static uint8_t out[TEST_MAX_BLOCK];
+    uint8_t delivered = 0;
+
+    for (uint8_t k = 0; k < batch.count; k++) {
+        uint8_t i = order[k];
+        if (lost[i]) {
+            continue;
+        }
+        int32_t result = reassembler.add(batch.frames[i], batch.sizes[i], out, sizeof(out));
+        CHECK(result >= 0);
+        if (result > 0) {
+            CHECK((result == size) && (memcmp(out, block, size) == 0));
+            delivered++;
+        }
+    }
+
+    return delivered;
+}
+
+// Every block is delivered once on the in-order, no-loss path (with and without parity)
+static void testInOrder() {
+    static const uint8_t PAYLOADS[] = {11, 14, 53, 64, 125, 222};
+    static Reassembler reassembler;
+    static Batch_t batch;
+    uint8_t block[TEST_MAX_BLOCK];
+    uint8_t order[TEST_MAX_FRAMES];
+    bool lost[TEST_MAX_FRAMES] = {false};
+    Fragmenter fragmenter;
+
+    for (uint8_t k = 0; k < TEST_MAX_FRAMES; k++) {
+        order[k] = k;
+    }
+    for (uint8_t parity = 0; parity < 2; parity++) {
+        for (uint8_t p = 0; p < sizeof(PAYLOADS); p++) {
+            for (uint16_t size = 1; size <= TEST_MAX_BLOCK; size += 7) {
+                fillBlock(block, size);
+                if (!fragmenter.begin(block, size, PAYLOADS[p], parity != 0)) {
+                    continue;
+                }
+                split(fragmenter, batch);
+                uint8_t dataCount = (size + PAYLOADS[p] - FRAGMENT_HEADER_SIZE - 1) / (PAYLOADS[p] - FRAGMENT_HEADER_SIZE);
+                CHECK(batch.count == dataCount + (((parity != 0) && (dataCount > 1)) ? 1 : 0));
+                CHECK(deliver(reassembler, batch, order, lost, block, size) == 1);
+            }
+        }
+    }
+}
+
+// One lost fragment (data or parity) is rebuilt, in any arrival order
+static void testOneLoss() {
+    static Reassembler reassembler;
+    static Batch_t batch;
+    uint8_t block[TEST_MAX_BLOCK];
+    uint8_t order[TEST_MAX_FRAMES];
+    bool lost[TEST_MAX_FRAMES];
+    Fragmenter fragmenter;
+
+    for (uint16_t trial = 0; trial < 2000; trial++) {
+        uint16_t size = 1 + rand() % TEST_MAX_BLOCK;
+        uint8_t maxPayload = FRAGMENT_HEADER_SIZE + 8 + rand() % (TEST_MAX_PAYLOAD - FRAGMENT_HEADER_SIZE - 8);
+        fillBlock(block, size);
+        CHECK(fragmenter.begin(block, size, maxPayload, true));
+        split(fragmenter, batch);
+
+        // Fisher-Yates shuffle
+        for (uint8_t k = 0; k < batch.count; k++) {
+            order[k] = k;
+            lost[k] = false;
+        }
+        for (uint8_t k = batch.count - 1; k > 0; k--) {
+            uint8_t j = rand() % (k + 1);
+            uint8_t t = order[k];
+            order[k] = order[j];
+            order[j] = t;
+        }
+        if (batch.count > 1) {
+            lost[rand() % batch.count] = true;
+        }
+        CHECK(deliver(reassembler, batch, order, lost, block, size) == 1);
+    }
+}
+
+// Two lost fragments drop the block, without stalling the next ones
+static void testTwoLosses() {
+    static Reassembler reassembler;
+    static Batch_t batch;
+    uint8_t block[TEST_MAX_BLOCK];
+    uint8_t order[TEST_MAX_FRAMES];
+    bool lost[TEST_MAX_FRAMES] = {false};
+    Fragmenter fragmenter;
+
+    for (uint8_t k = 0; k < TEST_MAX_FRAMES; k++) {
+        order[k] = k;
+    }
+    for (uint16_t trial = 0; trial < 300; trial++) {
+        fillBlock(block, 160);
+        CHECK(fragmenter.begin(block, 160, 53, true));
+        split(fragmenter, batch);
+        lost[0] = (trial % 2) == 0;
+        lost[1] = lost[0];
+        CHECK(deliver(reassembler, batch, order, lost, block, 160) == (lost[0] ? 0 : 1));
+    }
+}
+
+// Repeated fragments are ignored
+static void testRepeats() {
+    static Reassembler reassembler;
+    static Batch_t batch;
+    uint8_t block[TEST_MAX_BLOCK];
+    uint8_t order[2 * TEST_MAX_FRAMES];
+    bool lost[TEST_MAX_FRAMES] = {false};
+    Fragmenter fragmenter;
+
+    fillBlock(block, 100);
+    CHECK(fragmenter.begin(block, 100, 24, true));
+    split(fragmenter, batch);
+    for (uint8_t k = 0; k < batch.count; k++) {
+        order[2 * k] = k;
+        order[2 * k + 1] = k;
+    }
+    uint8_t count = batch.count;
+    batch.count = 2 * count;
+    CHECK(deliver(reassembler, batch, order, lost, block, 100) == 1);
+}
+
+int main() {
+    srand(1);
+    testInOrder();
+    testOneLoss();
+    testTwoLosses();
+    testRepeats();
+
+    return hostTestResult("fragment_test");
+}
@@ -0,0 +1,195 @@
+/**
+ * @file hex_bench.cpp
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Host micro-benchmark of the hex encoders of convert_tools.h against the
+ *        former String(value, HEX) implementation.
+ * @details Build and run from the repository root:\n
+ *          g++ -std=gnu++11 -O2 -Itools/host -Iinclude tools/host/hex_bench.cpp -o hex_bench && ./hex_bench\n
+ *          Costs are host cycles per encoded byte (TSC on x86, otherwise nanoseconds),
+ *          median of the runs. String uses the host shim of Arduino WString, so the
+ *          heap allocations of the former functions are counted; absolute values are
+ *          not AVR cycles.
+ * @version alpha
+ * @since 17/10/2026
+ * @date 17/10/2026
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#include <Arduino.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include "convert_tools.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT "cycles"
+static inline uint64_t benchTicks() {
+    return __rdtsc();
+}
+#else
+#define BENCH_UNIT "ns"
+static inline uint64_t benchTicks() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+#define BENCH_RUNS          1001
+#define BENCH_MAX_SIZE      51
+
+/**
+ * @class NullPrint
+ * @brief Output that counts and drops the text (stands for the modem UART).
+ */
+class NullPrint : public Print {
+    public:
+        uint32_t bytes = 0;
+
+        size_t write(uint8_t) override {
+            this->bytes++;
+            return 1;
+        }
+        using Print::write;
+};
+
+/**
+ * @fn legacyByte2hex
+ * @brief Former byte2hex() (String(value, HEX) plus "0" padding).
+ */
+static String legacyByte2hex(uint8_t value) {
+    String hex = "";
+
+    if (value <= 0xF) {
+        hex.concat("0");
+    }
+    hex.concat(String(value, HEX));
+
+    return hex;
+}
+
+/**
+ * @fn legacyLong2hex
+ * @brief Former long2hex() (highest byte first).
+ */
+static String legacyLong2hex(uint32_t value) {
+    String hex = "";
+
+    for (int8_t shift = 24; shift >= 0; shift -= 8) {
+        uint8_t aux = (uint8_t)(value >> shift);
+        if (aux <= 0xF) {
+            hex.concat("0");
+        }
+        hex.concat(String(aux, HEX));
+    }
+
+    return hex;
+}
+
+// Keep results alive, so the compiler does not drop the encoding
+static inline void benchUse(const void* p) {
+    asm volatile("" : : "r"(p) : "memory");
+}
+
+/**
+ * @fn measure
+ * @brief Median cost per byte of encoding \p size bytes.
+ */
+template <class Operation>
+static uint64_t measure(size_t size, Operation operation) {
+    std::vector<uint64_t> costs;
+
+    for (uint16_t i = 0; i < BENCH_RUNS; i++) {
+        uint64_t start = benchTicks();
+        operation();
+        costs.push_back(benchTicks() - start);
+    }
+    std::sort(costs.begin(), costs.end());
+
+    return (costs[costs.size() / 2] + size / 2) / size;
+}
+
+int main() {
+    static const size_t SIZES[] = {1, 11, BENCH_MAX_SIZE};
+    uint8_t buf[BENCH_MAX_SIZE];
+    char hex[2 * BENCH_MAX_SIZE + 1];
+    NullPrint out;
+    uint8_t fails = 0;
+
+    for (uint8_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = (uint8_t)(i * 37 + 5);
+    }
+
+    // Same digits as the former functions
+    for (uint16_t value = 0; value <= 0xFF; value++) {
+        fails += (byte2hex(value) != legacyByte2hex(value));
+    }
+    fails += (long2hex(0x0A1B2C3DUL) != legacyLong2hex(0x0A1B2C3DUL));
+    fails += (long2hex(0x00000001UL) != legacyLong2hex(0x00000001UL));
+    if (fails != 0) {
+        printf("FAILED: %u outputs differ from the former functions\n", fails);
+        return 1;
+    }
+
+    printf("Hex encoders (%s per byte, median of %u runs)\n", BENCH_UNIT, BENCH_RUNS);
+    printf("  %-32s %8s %8s %8s\n", "encoder", "1 B", "11 B", "51 B");
+
+    printf("  %-32s", "String(value, HEX) + concat");
+    for (size_t size : SIZES) {
+        printf(" %8llu", (unsigned long long)measure(size, [&]() {
+            String msg = "";
+            for (size_t i = 0; i < size; i++) {
+                msg.concat(legacyByte2hex(buf[i]));
+            }
+            benchUse(msg.c_str());
+        }));
+    }
+
+    printf("\n  %-32s", "byte2hex() + concat");
+    for (size_t size : SIZES) {
+        printf(" %8llu", (unsigned long long)measure(size, [&]() {
+            String msg = "";
+            for (size_t i = 0; i < size; i++) {
+                msg.concat(byte2hex(buf[i]));
+            }
+            benchUse(msg.c_str());
+        }));
+    }
+
+    printf("\n  %-32s", "bytes2hex() to buffer");
+    for (size_t size : SIZES) {
+        printf(" %8llu", (unsigned long long)measure(size, [&]() {
+            bytes2hex(buf, size, hex);
+            benchUse(hex);
+        }));
+    }
+
+    printf("\n  %-32s", "printHex() to Print");
+    for (size_t size : SIZES) {
+        printf(" %8llu", (unsigned long long)measure(size, [&]() {
+            printHex(out, buf, size);
+            benchUse(&out);
+        }));
+    }
+
+    printf("\n\n  %-32s %8s\n", "UINT_32 (per byte)", "4 B");
+    printf("  %-32s %8llu\n", "former long2hex()", (unsigned long long)measure(4, [&]() {
+        String s = legacyLong2hex(0x0A1B2C3DUL);
+        benchUse(s.c_str());
+    }));
+    printf("  %-32s %8llu\n", "long2hex()", (unsigned long long)measure(4, [&]() {
+        String s = long2hex(0x0A1B2C3DUL);
+        benchUse(s.c_str());
+    }));
+    printf("  %-32s %8llu\n", "long2hexBE() to buffer", (unsigned long long)measure(4, [&]() {
+        long2hexBE(0x0A1B2C3DUL, hex);
+        benchUse(hex);
+    }));
+
+    return 0;
+}
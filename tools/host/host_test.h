@@ -0,0 +1,54 @@
+/**
+ * @file host_test.h
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Minimal check macro of the host tests (tools/host, files named *_test.cpp).
+ * @version alpha
+ * @since 17/10/2026
+ * @date 17/10/2026
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __HOST_TEST_H__
+#define __HOST_TEST_H__
+
+#include <stdio.h>
+
+/**
+ * @fn hostTestChecks
+ * @brief Number of checks run and failed (only the first failures are printed).
+ */
+inline unsigned long* hostTestChecks() {
+    static unsigned long checks[2] = {0, 0};
+    return checks;
+}
+
+inline void hostTestCheck(bool passed, const char* expr, const char* file, int line) {
+    hostTestChecks()[0]++;
+    if (!passed) {
+        if (hostTestChecks()[1]++ < 10) {
+            printf("%s:%d: check failed: %s\n", file, line, expr);
+        }
+    }
+}
+
+// Variadic, so template arguments (e.g. to_fixed<16, 100>(x)) need no extra parentheses
+#define CHECK(...)      hostTestCheck((__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+
+/**
+ * @fn hostTestResult
+ * @brief Print the summary of a test program.
+ * @return int - exit status (0 if every check passed).
+ */
+inline int hostTestResult(const char* name) {
+    printf("%s: %lu checks, %lu failed\n", name, hostTestChecks()[0], hostTestChecks()[1]);
+
+    return (hostTestChecks()[1] == 0) ? 0 : 1;
+}
+
+#endif // __HOST_TEST_H__
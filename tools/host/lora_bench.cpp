@@ -0,0 +1,218 @@
+/**
+ * @file lora_bench.cpp
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Host benchmark of the RHF76 driver with the release (\ref LoRaNoLog) and debug
+ *        (\ref LoRaSerialLog) policies, over \ref FakeTransport.
+ * @details Build and run from the repository root:\n
+ *          g++ -std=gnu++11 -O2 -Itools/host -Iinclude tools/host/lora_bench.cpp -o lora_bench && ./lora_bench\n
+ *          Costs are host cycles (TSC on x86, otherwise nanoseconds), median of the runs,
+ *          and include the fake modem answering every command. They compare the two
+ *          policies on the same host; they are not AVR cycles. The debug policy prints
+ *          to a sink that drops the text, so UART time is not counted either.
+ * @version alpha
+ * @since 17/10/2026
+ * @date 17/10/2026
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include "FakeTransport.h"
+#include "convert_tools.h"
+#include "RHF76.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT "cycles"
+static inline uint64_t benchTicks() {
+    return __rdtsc();
+}
+#else
+#define BENCH_UNIT "ns"
+static inline uint64_t benchTicks() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+#define BENCH_RUNS          201
+#define BENCH_PAYLOAD_SIZE  11
+
+/**
+ * @class NullPrint
+ * @brief Debug output that counts and drops the text.
+ */
+class NullPrint : public Print {
+    public:
+        uint32_t bytes = 0;
+
+        size_t write(uint8_t) override {
+            this->bytes++;
+            return 1;
+        }
+        using Print::write;
+};
+
+/**
+ * @struct BenchResult_t
+ * @brief Cost of one operation.
+ */
+struct BenchResult_t {
+    uint64_t median;        /**< Median cost (in BENCH_UNIT). */
+    uint64_t min;           /**< Lowest cost (in BENCH_UNIT). */
+    uint32_t commands;      /**< AT commands per operation. */
+    uint32_t uartBytes;     /**< Bytes written to the modem per operation. */
+    uint32_t logBytes;      /**< Debug bytes per operation. */
+};
+
+static NullPrint logSink;
+
+/**
+ * @fn benchConfig
+ * @brief Configuration of the node (src/main.cpp), without airtime budget, link checks,
+ *        time sync and modem sleep, so every run sends the same commands.
+ */
+static LoRaConfig_t benchConfig() {
+    LoRaConfig_t config;
+
+    config.uart_baudrate = 115200;
+    config.baseband = AU920;
+    config.subband = 2;
+    config.op_class = A;
+    config.tx_power = dBm20;
+    config.uplink_dr = DR1;
+    config.chan0_dr = DR1;
+    config.chan1_dr = DR1;
+    config.rxwin2_dr = DR8;
+    config.adr = OFF;
+    config.auth_mode = LWABP;
+    config.dev_eui = "0004A30B001C0530";
+    config.app_eui = "70B3D57ED0012345";
+    config.retry = 0;
+    config.retry_backoff = 0;
+    config.confirm_every = 0;
+    config.link_check_every = 0;
+    config.time_sync_period = 0;
+    config.airtime_budget = 0;
+    config.airtime_window = 0;
+    config.downlink_budget = 0;
+    config.low_power = false;
+    config.dev_addr = "26011B4C";
+    config.app_key = "2B7E151628AED2A6ABF7158809CF4F3C";
+    config.apps_key = "2B7E151628AED2A6ABF7158809CF4F3C";
+    config.nwks_key = "2B7E151628AED2A6ABF7158809CF4F3C";
+    config.eeprom_addr = 0;
+
+    return config;
+}
+
+/**
+ * @fn measure
+ * @brief Run an operation BENCH_RUNS times (after \p setup, which is not timed).
+ */
+template <class Setup, class Operation>
+static BenchResult_t measure(FakeTransport& modem, Setup setup, Operation operation) {
+    std::vector<uint64_t> costs;
+    BenchResult_t result;
+
+    modem.commands = 0;
+    modem.bytesWritten = 0;
+    logSink.bytes = 0;
+    for (uint16_t i = 0; i < BENCH_RUNS; i++) {
+        setup();
+        uint64_t start = benchTicks();
+        operation();
+        costs.push_back(benchTicks() - start);
+    }
+    std::sort(costs.begin(), costs.end());
+    result.median = costs[costs.size() / 2];
+    result.min = costs[0];
+    result.commands = modem.commands / BENCH_RUNS;
+    result.uartBytes = modem.bytesWritten / BENCH_RUNS;
+    result.logBytes = logSink.bytes / BENCH_RUNS;
+
+    return result;
+}
+
+static void report(const char* name, const BenchResult_t& result) {
+    printf("  %-30s %12llu %12llu %9lu %10lu %9lu\n", name, (unsigned long long)result.median,
+           (unsigned long long)result.min, (unsigned long)result.commands,
+           (unsigned long)result.uartBytes, (unsigned long)result.logBytes);
+}
+
+/**
+ * @fn runBench
+ * @brief Measure the driver operations with a logging policy.
+ */
+template <class Log>
+static void runBench(const char* title) {
+    FakeTransport modem;
+    RHF76<FakeTransport, Log> lora(modem);
+    LoRaConfig_t config = benchConfig();
+    uint8_t payload[BENCH_PAYLOAD_SIZE];
+    String payloadHex = "";
+    uint8_t statusCode = LORA_STATUS_OK;
+
+    for (uint8_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = 0x11 * i;
+        payloadHex.concat(byte2hex(payload[i]));
+    }
+
+    printf("\n%s\n  %-30s %12s %12s %9s %10s %9s\n", title, "operation", "median " BENCH_UNIT, "min", "AT cmds", "UART bytes", "log bytes");
+
+    report("init (first boot)", measure(modem,
+        [&]() { EEPROM.erase(); modem.factoryReset(); },
+        [&]() { statusCode |= lora.init(config); }));
+
+    report("init (configuration kept)", measure(modem,
+        [&]() {},
+        [&]() { statusCode |= lora.init(config); }));
+
+    report("getFWVersion", measure(modem,
+        [&]() {},
+        [&]() { lora.getFWVersion(); }));
+
+    report("sendNoAckMsgHex (bytes)", measure(modem,
+        [&]() {},
+        [&]() {
+            statusCode |= lora.sendNoAckMsgHex(1, payload, sizeof(payload));
+            while (lora.isBusy()) {
+                lora.poll();
+            }
+        }));
+
+    report("sendNoAckMsgHex (String)", measure(modem,
+        [&]() {},
+        [&]() {
+            statusCode |= lora.sendNoAckMsgHex(1, payloadHex);
+            while (lora.isBusy()) {
+                lora.poll();
+            }
+        }));
+
+    report("poll (idle)", measure(modem,
+        [&]() {},
+        [&]() { lora.poll(); }));
+
+    if ((statusCode != LORA_STATUS_OK) || (lora.getTxStatus() != LORA_TX_DONE)) {
+        printf("  FAILED (status %u, TX status %u, last response \"%s\")\n", statusCode, lora.getTxStatus(), lora.getATResponse());
+    }
+}
+
+int main() {
+    LoRaSerialLog::begin(logSink);
+
+    printf("RHF76 driver over FakeTransport (%u runs per operation, %u byte payload)\n", BENCH_RUNS, BENCH_PAYLOAD_SIZE);
+    runBench<LoRaNoLog>("LoRaNoLog (release)");
+    runBench<LoRaSerialLog>("LoRaSerialLog (SERIAL_DEBUG_ENABLED)");
+
+    return 0;
+}
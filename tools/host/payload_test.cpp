@@ -0,0 +1,164 @@
+/**
+ * @file payload_test.cpp
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Host test of the uplink payload codec (\ref encodePayload() and \ref decodePayload()),
+ *        full and delta frames.
+ * @details Build and run from the repository root (or run tools/host/run_tests.sh):\n
+ *          g++ -std=gnu++11 -O2 -Itools/host -Iinclude tools/host/payload_test.cpp -o payload_test && ./payload_test
+ * @version alpha
+ * @since 17/10/2026
+ * @date 17/10/2026
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "PayloadCodec.h"
+#include "host_test.h"
+
+#define TEST_ALL_FIELDS     ((1 << FIELD_COUNT) - 1)
+#define TEST_MAX_SIZE       (getPayloadSize(TEST_ALL_FIELDS))
+
+/**
+ * @fn randomFrame
+ * @brief Random raw values of \p fields, each one present with probability 3/4.
+ */
+static void randomFrame(uint16_t fields, payload_frame_t& frame) {
+    memset(&frame, 0, sizeof(frame));
+    for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+        if ((fields & (1 << i)) && ((rand() % 4) != 0)) {
+            frame.present |= 1 << i;
+            if (field_schema[i].bits <= 16) {
+                frame.raw[i] = (uint16_t)rand() & ((1UL << field_schema[i].bits) - 1);
+            }
+        }
+    }
+    for (uint8_t j = 0; j < FIELD_LINK_HEALTH_SIZE; j++) {
+        frame.linkHealth[j] = (uint8_t)rand();
+    }
+}
+
+/**
+ * @fn sameFrame
+ * @brief Compare the fields of two frames (values of missing fields are not sent).
+ */
+static bool sameFrame(uint16_t fields, const payload_frame_t& a, const payload_frame_t& b) {
+    if ((a.present & fields) != b.present) {
+        return false;
+    }
+    for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+        if ((b.present & (1 << i)) && ((1 << i) != FIELD_LINK_HEALTH) && (a.raw[i] != b.raw[i])) {
+            return false;
+        }
+    }
+    return !(b.present & FIELD_LINK_HEALTH) || (memcmp(a.linkHealth, b.linkHealth, FIELD_LINK_HEALTH_SIZE) == 0);
+}
+
+// Full frames of any fields decode to the values written, within the maximum size
+static void testRoundTrip() {
+    uint8_t buf[TEST_MAX_SIZE];
+    payload_frame_t frame;
+    payload_frame_t decoded;
+
+    for (uint16_t trial = 0; trial < 5000; trial++) {
+        uint16_t fields = (uint16_t)rand() & TEST_ALL_FIELDS;
+        randomFrame(fields, frame);
+        uint8_t size = encodePayload(fields, frame, NULL, buf);
+        CHECK(size <= getPayloadSize(fields));
+        CHECK(decodePayload(fields, buf, size, NULL, decoded) == size);
+        CHECK(sameFrame(fields, frame, decoded));
+    }
+}
+
+// Truncated frames are rejected
+static void testTruncated() {
+    uint8_t buf[TEST_MAX_SIZE];
+    payload_frame_t frame;
+    payload_frame_t decoded;
+
+    for (uint16_t trial = 0; trial < 500; trial++) {
+        randomFrame(TEST_ALL_FIELDS, frame);
+        frame.present |= FIELD_LIGHT | FIELD_TIMESTAMP;
+        uint8_t size = encodePayload(TEST_ALL_FIELDS, frame, NULL, buf);
+        for (uint8_t cut = 0; cut < size; cut++) {
+            CHECK(decodePayload(TEST_ALL_FIELDS, buf, cut, NULL, decoded) == 0);
+        }
+    }
+}
+
+// Delta frames decode against their keyframe, and differences out of range are refused
+static void testDelta() {
+    uint8_t buf[TEST_MAX_SIZE];
+    payload_frame_t keyframe;
+    payload_frame_t frame;
+    payload_frame_t decoded;
+
+    for (uint16_t trial = 0; trial < 5000; trial++) {
+        uint16_t fields = (uint16_t)rand() & TEST_ALL_FIELDS;
+        bool overflow = false;
+        randomFrame(fields, keyframe);
+        randomFrame(fields, frame);
+
+        // Most differences within the field delta width, a few beyond it
+        for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+            const field_schema_t& schema = field_schema[i];
+            if ((schema.deltaBits == 0) || !(frame.present & keyframe.present & (1 << i))) {
+                continue;
+            }
+            int32_t limit = 1L << (schema.deltaBits - 1);
+            int32_t delta = (rand() % 50 == 0) ? limit : (rand() % (2 * limit)) - limit;
+            int32_t raw = (int32_t)keyframe.raw[i] + delta;
+            if ((raw < 0) || (raw >= (1L << schema.bits))) {
+                raw = keyframe.raw[i];
+                delta = 0;
+            }
+            frame.raw[i] = raw;
+            overflow |= (delta == limit);
+        }
+
+        uint8_t size = encodePayload(fields, frame, &keyframe, buf);
+        if (overflow) {
+            CHECK(size == 0);
+            continue;
+        }
+        CHECK((size != 0) && (size <= getPayloadSize(fields)));
+        CHECK(size <= encodePayload(fields, frame, NULL, buf));
+        size = encodePayload(fields, frame, &keyframe, buf);
+        CHECK(decodePayload(fields, buf, size, &keyframe, decoded) == size);
+        CHECK(sameFrame(fields, frame, decoded));
+    }
+}
+
+// Values are rounded to the field resolution and limited to the field range
+static void testFields() {
+    CHECK(encodeField<FIELD_AIR_TEMP>(21.34f) == 613);
+    CHECK(decodeField(FIELD_AIR_TEMP, 613) > 21.29f);
+    CHECK(decodeField(FIELD_AIR_TEMP, 613) < 21.31f);
+    CHECK(encodeField<FIELD_AIR_TEMP>(-60.0f) == 0);
+    CHECK(encodeField<FIELD_AIR_TEMP>(500.0f) == 2047);
+    CHECK(encodeField<FIELD_AIR_TEMP>(0.0f / 0.0f) == 0);
+    CHECK(encodeField<FIELD_PRESSURE>(1013.26f) == 7133);
+    CHECK(encodeField<FIELD_RAIN>((uint16_t)20000) == 16383);
+    CHECK(encodeField<FIELD_WIND_DIR>((uint16_t)315) == 7);
+    CHECK(encodeField<FIELD_WIND_DIR>((uint16_t)22) == 0);
+    CHECK(encodeField<FIELD_WIND_DIR>((uint16_t)23) == 1);
+    CHECK(decodeField(FIELD_WIND_DIR, 7) == 315.0f);
+    CHECK(getPayloadHeader(PAYLOAD_FLAG_RESET) == ((PAYLOAD_SCHEMA_VERSION << 4) | PAYLOAD_FLAG_RESET));
+}
+
+int main() {
+    srand(1);
+    testRoundTrip();
+    testTruncated();
+    testDelta();
+    testFields();
+
+    return hostTestResult("payload_test");
+}
@@ -0,0 +1,138 @@
+/**
+ * @file rhf76_test.cpp
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Host test of the RHF76 background tasks (\ref RHF76::poll()), over \ref FakeTransport.
+ * @details Build and run from the repository root (or run tools/host/run_tests.sh):\n
+ *          g++ -std=gnu++11 -O2 -Itools/host -Iinclude tools/host/rhf76_test.cpp -o rhf76_test && ./rhf76_test\n
+ *          The fake modem answers every command at once, so a task waiting for its
+ *          answer inside poll() shows up as more than one command sent by a single call.
+ * @version alpha
+ * @since 17/10/2026
+ * @date 17/10/2026
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <stdio.h>
+#include "FakeTransport.h"
+#include "RHF76.h"
+#include "host_test.h"
+
+#define TEST_MESSAGES       40
+#define TEST_MAX_POLLS      100
+
+typedef RHF76<FakeTransport, LoRaNoLog> Radio;
+
+/**
+ * @fn testConfig
+ * @brief Battery node with ADR (every transmission ends with the frame counters,
+ *        datarate and low power tasks).
+ */
+static LoRaConfig_t testConfig(LoRaAuthMode_e authMode) {
+    LoRaConfig_t config;
+
+    config.uart_baudrate = 115200;
+    config.baseband = AU920;
+    config.subband = 2;
+    config.op_class = A;
+    config.tx_power = dBm20;
+    config.uplink_dr = DR1;
+    config.chan0_dr = DR1;
+    config.chan1_dr = DR1;
+    config.rxwin2_dr = DR8;
+    config.adr = ON;
+    config.auth_mode = authMode;
+    config.dev_eui = "0004A30B001C0530";
+    config.app_eui = "70B3D57ED0012345";
+    config.retry = 0;
+    config.retry_backoff = 0;
+    config.confirm_every = 0;
+    config.link_check_every = 0;
+    config.time_sync_period = 0;
+    config.airtime_budget = 0;
+    config.airtime_window = 0;
+    config.downlink_budget = 0;
+    config.low_power = true;
+    config.dev_addr = "26011B4C";
+    config.app_key = "2B7E151628AED2A6ABF7158809CF4F3C";
+    config.apps_key = "2B7E151628AED2A6ABF7158809CF4F3C";
+    config.nwks_key = "2B7E151628AED2A6ABF7158809CF4F3C";
+    config.eeprom_addr = 0;
+
+    return config;
+}
+
+/**
+ * @fn pollUntil
+ * @brief Call poll() until the driver is idle (and joined if \p joined), checking that
+ *        each call sends one command at most.
+ * @return uint16_t - number of calls.
+ */
+static uint16_t pollUntil(Radio& lora, FakeTransport& modem, bool joined) {
+    uint16_t polls = 0;
+
+    // Tasks may start a command on any call, so the driver is idle only after a call
+    do {
+        uint32_t commands = modem.commands;
+        lora.poll();
+        CHECK((modem.commands - commands) <= 1);
+        polls++;
+        delay(LORA_WAKE_DELAY);
+    } while ((lora.isBusy() || (joined && !lora.isJoined())) && (polls < TEST_MAX_POLLS));
+
+    return polls;
+}
+
+// Frame counters, datarate and low power mode after each message, one command per poll()
+static void testAfterTx() {
+    FakeTransport modem;
+    Radio lora(modem);
+    uint8_t payload[11] = {0};
+
+    EEPROM.erase();
+    CHECK(lora.init(testConfig(LWABP)) == LORA_STATUS_OK);
+    pollUntil(lora, modem, false);
+    for (uint8_t i = 0; i < TEST_MESSAGES; i++) {
+        CHECK(lora.sendNoAckMsgHex(1, payload, sizeof(payload)) == LORA_STATUS_OK);
+        CHECK(!modem.sleeping);
+        CHECK(pollUntil(lora, modem, false) < TEST_MAX_POLLS);
+        CHECK(lora.getTxStatus() == LORA_TX_DONE);
+        CHECK(modem.sleeping);
+    }
+    CHECK(modem.calls["MSGHEX"] == TEST_MESSAGES);
+    CHECK(modem.calls["DR"] >= TEST_MESSAGES);
+    CHECK(modem.calls["LOWPOWER"] == TEST_MESSAGES + 1);
+    CHECK(modem.calls["LW"] >= (TEST_MESSAGES / LORA_FCNT_SAVE_INTERVAL));
+}
+
+// Join retried after a refused join wakes the sleeping modem up without blocking
+static void testJoinWake() {
+    FakeTransport modem;
+    Radio lora(modem);
+
+    EEPROM.erase();
+    modem.joinFailures = 1;
+    CHECK(lora.init(testConfig(LWOTAA)) == LORA_STATUS_OK);
+    pollUntil(lora, modem, false);
+    CHECK(!lora.isJoined());
+    CHECK(modem.sleeping);
+
+    delay(LORA_JOIN_BACKOFF * 2);
+    CHECK(pollUntil(lora, modem, true) < TEST_MAX_POLLS);
+    CHECK(lora.isJoined());
+    CHECK(modem.calls["JOIN"] == 2);
+}
+
+int main() {
+    testAfterTx();
+    testJoinWake();
+
+    return hostTestResult("rhf76_test");
+}
@@ -0,0 +1,27 @@
+#!/bin/sh
+#
+# Build and run the host tests (tools/host/*_test.cpp).
+#
+# Usage (from the repository root, with any C++11 compiler):
+#   sh tools/host/run_tests.sh
+#
+# CXX selects the compiler (default g++). Exits with an error if a test fails
+# to build or any of its checks fails.
+
+CXX=${CXX:-g++}
+OUT=$(mktemp -d)
+status=0
+
+trap 'rm -rf "$OUT"' EXIT
+
+for test in tools/host/*_test.cpp; do
+    name=$(basename "$test" .cpp)
+    if ! $CXX -std=gnu++11 -O2 -Wall -Wextra -Itools/host -Iinclude "$test" -o "$OUT/$name"; then
+        echo "$name: build failed"
+        status=1
+        continue
+    fi
+    "$OUT/$name" || status=1
+done
+
+exit $status
@@ -0,0 +1,150 @@
+/**
+ * @file stats_test.cpp
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Host test of the window statistics (\ref FieldStats) and of their encoding in
+ *        channel frames (\ref PAYLOAD_FLAG_STATS).
+ * @details Build and run from the repository root (or run tools/host/run_tests.sh):\n
+ *          g++ -std=gnu++11 -O2 -Itools/host -Iinclude tools/host/stats_test.cpp -o stats_test && ./stats_test
+ * @version alpha
+ * @since 17/10/2026
+ * @date 17/10/2026
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "FieldStats.h"
+#include "PayloadCodec.h"
+#include "host_test.h"
+
+#define TEST_MAX_SAMPLES    255
+
+// Statistics match a double precision two-pass reference
+static void testWindow() {
+    static uint16_t samples[TEST_MAX_SAMPLES];
+    FieldStats stats;
+
+    for (uint16_t trial = 0; trial < 2000; trial++) {
+        uint8_t count = 1 + rand() % TEST_MAX_SAMPLES;
+        // Narrow windows around any level, wide ones over the whole range
+        uint16_t base = (uint16_t)rand();
+        uint16_t spread = (trial % 2) ? 65535 : 1 + rand() % 64;
+        double mean = 0.0;
+        double variance = 0.0;
+        uint16_t minimum = 65535;
+        uint16_t maximum = 0;
+
+        stats.reset();
+        for (uint8_t i = 0; i < count; i++) {
+            uint32_t raw = base + (uint32_t)rand() % spread;
+            samples[i] = (raw > 65535) ? 65535 : raw;
+            stats.add(samples[i]);
+            mean += samples[i];
+            minimum = (samples[i] < minimum) ? samples[i] : minimum;
+            maximum = (samples[i] > maximum) ? samples[i] : maximum;
+        }
+        mean /= count;
+        for (uint8_t i = 0; i < count; i++) {
+            variance += (samples[i] - mean) * (samples[i] - mean);
+        }
+        variance /= count;
+
+        CHECK(stats.getCount() == count);
+        CHECK(stats.getMin() == minimum);
+        CHECK(stats.getMax() == maximum);
+        CHECK(fabs(stats.getMean() - mean) <= 1e-3 * (1.0 + maximum));
+        CHECK(fabs(stats.getStdDev() - sqrt(variance)) <= 1.0 + 1e-4 * sqrt(variance));
+    }
+}
+
+// Empty, constant and full windows
+static void testLimits() {
+    FieldStats stats;
+
+    CHECK(stats.getCount() == 0);
+    CHECK(stats.getMin() == 0);
+    CHECK(stats.getMax() == 0);
+    CHECK(stats.getMean() != stats.getMean());
+    CHECK(stats.getStdDev() == 0);
+
+    for (uint16_t i = 0; i < 300; i++) {
+        stats.add(1000);
+    }
+    CHECK(stats.getCount() == 255);
+    CHECK(stats.getMean() == 1000.0f);
+    CHECK(stats.getStdDev() == 0);
+
+    // Samples after the 255th are ignored
+    stats.add(0);
+    CHECK(stats.getMin() == 1000);
+
+    stats.reset();
+    stats.add(0);
+    stats.add(65535);
+    CHECK(stats.getMin() == 0);
+    CHECK(stats.getMax() == 65535);
+    CHECK(stats.getStdDev() == 32768);
+}
+
+// Statistics of the present fields follow the fields and decode back
+static void testFrame() {
+    uint16_t fields = FIELD_AIR_TEMP | FIELD_AIR_HUMID | FIELD_PRESSURE | FIELD_LINK_HEALTH | FIELD_TIMESTAMP;
+    uint8_t buf[64];
+    payload_frame_t frame;
+    payload_frame_t decoded;
+    payload_stats_t stats;
+    payload_stats_t decodedStats;
+
+    memset(&frame, 0, sizeof(frame));
+    memset(&stats, 0, sizeof(stats));
+    memset(&decodedStats, 0, sizeof(decodedStats));
+    frame.present = fields & ~FIELD_AIR_HUMID;
+    frame.raw[getFieldIndex(FIELD_AIR_TEMP)] = 613;
+    frame.raw[getFieldIndex(FIELD_PRESSURE)] = 7133;
+    frame.raw[getFieldIndex(FIELD_TIMESTAMP)] = 4321;
+    stats.fields[STAT_MIN] = FIELD_AIR_TEMP | FIELD_AIR_HUMID | FIELD_PRESSURE | FIELD_LINK_HEALTH;
+    stats.fields[STAT_MAX] = stats.fields[STAT_MIN];
+    stats.fields[STAT_STDDEV] = FIELD_AIR_TEMP;
+    stats.raw[STAT_MIN][getFieldIndex(FIELD_AIR_TEMP)] = 598;
+    stats.raw[STAT_MAX][getFieldIndex(FIELD_AIR_TEMP)] = 650;
+    stats.raw[STAT_STDDEV][getFieldIndex(FIELD_AIR_TEMP)] = 17;
+    stats.raw[STAT_MIN][getFieldIndex(FIELD_PRESSURE)] = 7120;
+    stats.raw[STAT_MAX][getFieldIndex(FIELD_PRESSURE)] = 7140;
+    memcpy(decodedStats.fields, stats.fields, sizeof(stats.fields));
+
+    uint16_t statsBits = getStatsBits(stats.fields[STAT_MIN]) + getStatsBits(stats.fields[STAT_MAX]) +
+                         getStatsBits(stats.fields[STAT_STDDEV]);
+    uint8_t size = encodePayload(fields, frame, NULL, buf, &stats);
+    CHECK(size <= getPayloadSize(fields, statsBits));
+    CHECK(size > encodePayload(fields, frame, NULL, buf));
+    size = encodePayload(fields, frame, NULL, buf, &stats);
+    CHECK(decodePayload(fields, buf, size, NULL, decoded, &decodedStats) == size);
+    CHECK(decoded.present == frame.present);
+    for (uint8_t k = 0; k < STAT_COUNT; k++) {
+        for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+            if (stats.fields[k] & frame.present & ~FIELD_LINK_HEALTH & (1 << i)) {
+                CHECK(decodedStats.raw[k][i] == stats.raw[k][i]);
+            }
+        }
+    }
+
+    // Frame without its statistics is too short
+    CHECK(decodePayload(fields, buf, size - 1, NULL, decoded, &decodedStats) == 0);
+}
+
+int main() {
+    srand(1);
+    testWindow();
+    testLimits();
+    testFrame();
+
+    return hostTestResult("stats_test");
+}
@@ -0,0 +1,197 @@
+/**
+ * @file uplink_queue_test.cpp
+ * @author Robson Costa (robson.costa@ifsc.edu.br)
+ * @brief Host test of \ref UplinkQueue (SRAM frames, EEPROM spill ring, restore after a
+ *        reset and age out).
+ * @details Build and run from the repository root (or run tools/host/run_tests.sh):\n
+ *          g++ -std=gnu++11 -O2 -Itools/host -Iinclude tools/host/uplink_queue_test.cpp -o uplink_queue_test && ./uplink_queue_test\n
+ *          A reset is a new \ref UplinkQueue over the same EEPROM.
+ * @version alpha
+ * @since 17/10/2026
+ * @date 17/10/2026
+ *
+ * @copyright Copyright (c) 2019 - Robson Costa\n
+ * Licensed under the Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International Unported License (the <em>"License"</em>).
+ * You may not use this file except in compliance with the License. You may obtain a copy of the License at
+ * \url{https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode}. Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an <em>"as is" basis, without warranties or
+ * conditions of any kind</em>, either express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <deque>
+#include "host_test.h"
+// Host EEPROM.h supports single translation unit builds only
+#include "../../src/UplinkQueue.cpp"
+
+#define TEST_EEPROM_ADDR    256
+#define TEST_EEPROM_SLOTS   5
+#define TEST_MAX_AGE        60000UL
+
+/**
+ * @struct ModelFrame_t
+ * @brief Frame of the reference queue.
+ */
+struct ModelFrame_t {
+    uint16_t window;
+    bool spilled;       // Frame in the EEPROM ring (kept after a reset)
+};
+
+/**
+ * @fn modelPush
+ * @brief Queue a frame in the reference queue: the oldest SRAM frame is spilled when
+ *        the SRAM is full, and the oldest frame dropped when the ring is full.
+ */
+static void modelPush(std::deque<ModelFrame_t>& model, uint16_t window, uint8_t eepromSlots) {
+    uint8_t spilled = 0;
+
+    for (size_t i = 0; i < model.size(); i++) {
+        spilled += model[i].spilled ? 1 : 0;
+    }
+    if ((model.size() - spilled) == UPLINK_QUEUE_RAM_SLOTS) {
+        if (spilled == eepromSlots) {
+            model.pop_front();
+            spilled -= (eepromSlots != 0) ? 1 : 0;
+        }
+        if (eepromSlots != 0) {
+            model[spilled].spilled = true;
+        }
+    }
+    model.push_back({window, false});
+}
+
+/**
+ * @fn pushWindow
+ * @brief Queue a frame whose payload is its window index.
+ */
+static bool pushWindow(UplinkQueue& queue, uint16_t window) {
+    uint8_t buf[3] = {(uint8_t)(window >> 8), (uint8_t)window, (uint8_t)(window * 7)};
+
+    return queue.push(2 + window % 3, window, buf, 1 + window % 3);
+}
+
+/**
+ * @fn checkOldest
+ * @brief Check the oldest frame of the queue against the reference queue.
+ */
+static void checkOldest(UplinkQueue& queue, const std::deque<ModelFrame_t>& model) {
+    UplinkFrame_t frame;
+
+    CHECK(queue.count() == model.size());
+    if (model.empty()) {
+        CHECK(!queue.peek(frame));
+        return;
+    }
+    CHECK(queue.peek(frame));
+    uint16_t window = model.front().window;
+    CHECK(frame.window == window);
+    CHECK((frame.port == 2 + window % 3) && (frame.size == 1 + window % 3));
+    CHECK(frame.data[0] == (uint8_t)(window >> 8));
+    CHECK((frame.size < 2) || (frame.data[1] == (uint8_t)window));
+    CHECK((frame.size < 3) || (frame.data[2] == (uint8_t)(window * 7)));
+}
+
+// Random pushes, pops and resets follow the reference queue
+static void testModel(uint8_t eepromSlots) {
+    std::deque<ModelFrame_t> model;
+    uint16_t window = 0;
+
+    EEPROM.erase();
+    for (uint16_t run = 0; run < 200; run++) {
+        UplinkQueue queue(TEST_EEPROM_ADDR, eepromSlots, 0);
+
+        // Reset: only spilled frames are restored
+        while (!model.empty() && !model.back().spilled) {
+            model.pop_back();
+        }
+        checkOldest(queue, model);
+        for (uint16_t op = rand() % 40; op > 0; op--) {
+            if ((rand() % 3) != 0) {
+                CHECK(pushWindow(queue, window));
+                modelPush(model, window++, eepromSlots);
+            } else {
+                queue.pop();
+                if (!model.empty()) {
+                    model.pop_front();
+                }
+            }
+            checkOldest(queue, model);
+        }
+    }
+}
+
+// Oversized frames are refused
+static void testOversized() {
+    uint8_t buf[UPLINK_FRAME_SIZE + 1] = {0};
+
+    EEPROM.erase();
+    UplinkQueue queue(TEST_EEPROM_ADDR, TEST_EEPROM_SLOTS, 0);
+    CHECK(!queue.push(2, 0, buf, sizeof(buf)));
+    CHECK(queue.push(2, 0, buf, UPLINK_FRAME_SIZE));
+    CHECK(queue.count() == 1);
+}
+
+// A corrupted slot ends the restored ring (older frames are dropped)
+static void testCorruptSlot() {
+    EEPROM.erase();
+    {
+        UplinkQueue queue(TEST_EEPROM_ADDR, TEST_EEPROM_SLOTS, 0);
+        for (uint16_t window = 0; window < UPLINK_QUEUE_RAM_SLOTS + TEST_EEPROM_SLOTS; window++) {
+            pushWindow(queue, window);
+        }
+    }
+    // Slot 1 holds window 1
+    uint16_t addr = TEST_EEPROM_ADDR + sizeof(UplinkSlot_t) + offsetof(UplinkSlot_t, frame);
+    EEPROM.write(addr, EEPROM.read(addr) ^ 0x01);
+
+    UplinkQueue queue(TEST_EEPROM_ADDR, TEST_EEPROM_SLOTS, 0);
+    UplinkFrame_t frame;
+    CHECK(queue.count() == TEST_EEPROM_SLOTS - 2);
+    CHECK(queue.peek(frame) && (frame.window == 2));
+}
+
+// Frames older than the maximum age are dropped, restored ones age from the boot
+static void testAge() {
+    UplinkFrame_t frame;
+
+    // Host clock starts with the test program, like millis() at boot
+    EEPROM.erase();
+    {
+        UplinkQueue queue(TEST_EEPROM_ADDR, TEST_EEPROM_SLOTS, TEST_MAX_AGE);
+        for (uint16_t window = 0; window < UPLINK_QUEUE_RAM_SLOTS + TEST_EEPROM_SLOTS; window++) {
+            pushWindow(queue, window);
+        }
+    }
+    UplinkQueue queue(TEST_EEPROM_ADDR, TEST_EEPROM_SLOTS, TEST_MAX_AGE);
+    CHECK(queue.count() == TEST_EEPROM_SLOTS);
+    CHECK(queue.peek(frame) && (frame.window == 0) && (frame.timestamp == 0));
+    delay(TEST_MAX_AGE + 1);
+    pushWindow(queue, 100);
+    CHECK(queue.peek(frame) && (frame.window == 100));
+    CHECK(queue.count() == 1);
+
+    delay(TEST_MAX_AGE / 2);
+    pushWindow(queue, 101);
+    CHECK(queue.peek(frame) && (frame.window == 100));
+    delay(TEST_MAX_AGE / 2 + 1);
+    CHECK(queue.peek(frame) && (frame.window == 101));
+    CHECK(queue.count() == 1);
+    delay(TEST_MAX_AGE / 2);
+    CHECK(!queue.peek(frame));
+    CHECK(queue.count() == 0);
+}
+
+int main() {
+    srand(1);
+    testAge();
+    testModel(TEST_EEPROM_SLOTS);
+    testModel(1);
+    testModel(0);
+    testOversized();
+    testCorruptSlot();
+
+    return hostTestResult("uplink_queue_test");
+}
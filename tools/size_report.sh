@@ -0,0 +1,47 @@
+#!/bin/sh
+#
+# Flash/SRAM report of the firmware built from two git revisions.
+#
+# Usage (from the repository root, with PlatformIO installed):
+#   sh tools/size_report.sh <old revision> [new revision]
+#
+# New revision defaults to HEAD. Extra flags (e.g.
+# PLATFORMIO_BUILD_FLAGS=-DSERIAL_DEBUG_ENABLED for debug builds) are passed
+# to both builds. Prints avr-size of each firmware and the
+# largest LoRa symbols.
+
+set -e
+
+if [ $# -lt 1 ]; then
+    echo "usage: sh tools/size_report.sh <old revision> [new revision]" >&2
+    exit 2
+fi
+OLD=$1
+NEW=${2:-HEAD}
+ENV=megaatmega2560
+AVR_BIN=${AVR_BIN:-$HOME/.platformio/packages/toolchain-atmelavr/bin}
+WORK=$(mktemp -d)
+
+trap 'git worktree remove --force "$WORK/old" 2>/dev/null; git worktree remove --force "$WORK/new" 2>/dev/null; rm -rf "$WORK"' EXIT
+
+for side in old new; do
+    if [ "$side" = old ]; then rev=$OLD; else rev=$NEW; fi
+    git worktree add --detach "$WORK/$side" "$rev" > /dev/null
+    (cd "$WORK/$side" && pio run -e $ENV > "$WORK/$side.log" 2>&1) || {
+        echo "$side ($rev): build failed, see $WORK/$side.log"
+        trap - EXIT
+        exit 1
+    }
+done
+
+for side in old new; do
+    if [ "$side" = old ]; then rev=$OLD; else rev=$NEW; fi
+    elf="$WORK/$side/.pio/build/$ENV/firmware.elf"
+    echo "== $side: $(git rev-parse --short "$rev")"
+    "$AVR_BIN/avr-size" -A "$elf" | grep -E "^\.(text|data|bss) "
+    echo "-- largest LoRa symbols (bytes, name)"
+    "$AVR_BIN/avr-nm" -C -S --size-sort "$elf" | grep -i "lora\|RHF76" | tail -n 10 | \
+        while read -r addr size type name; do
+            printf "%8d %s\n" "0x$size" "$name"
+        done
+done